@@ -145,7 +145,7 @@ int main(int argc, const char **argv) {
                                    );
 
   // Launch kernel
-  matrixMultiply(M, N, K,
+  matrixMultiply(N, M, K,
                  o_A, LDA,
                  o_B, LDB,
                  o_C, LDC);
@@ -156,7 +156,7 @@ int main(int argc, const char **argv) {
     for (int m = 0; m < M; ++m) {
       float c = 0.0;
       for (int k = 0; k < K; ++k) {
-        c = A[m + k * LDA] * B[k + n * LDB];
+        c += A[m + k * LDA] * B[k + n * LDB];
       }
       Cref[m + n * LDC] = c;
     }
@@ -165,11 +165,13 @@ int main(int argc, const char **argv) {
   // Copy result to the host
   o_C.copyTo(C.data());
 
-  // Check correctness
+  /*
+  Check correctness. The backend compiler may contract the multiply-adds
+  into FMAs, so the result is not bitwise equal to the host reference
+  */
   for (int n = 0; n < N; ++n) {
     for (int m = 0; m < M; ++m) {
-      if (!occa::areBitwiseEqual(C[m + n * LDC],
-                                 Cref[m + n * LDC])) {
+      if (std::abs(C[m + n * LDC] - Cref[m + n * LDC]) > 1.0E-5 * K) {
         std::cout << "FAILED" << std::endl;
         throw 1;
       }
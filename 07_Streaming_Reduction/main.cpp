@@ -0,0 +1,294 @@
+#include <iostream>
+#include <fstream>
+#include <random>
+#include <chrono>
+#include <cstring>
+#include <cstdio>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <occa.hpp>
+
+//---[ Internal Tools ]-----------------
+// Note: These headers are not officially supported
+//       Please don't rely on it outside of the occa examples
+#include <occa/internal/utils/cli.hpp>
+#include <occa/internal/utils/testing.hpp>
+//======================================
+
+occa::json parseArgs(int argc, const char **argv) {
+  occa::cli::parser parser;
+  parser
+    .withDescription(
+      "Out-of-core streaming reduction"
+    )
+    .addOption(
+      occa::cli::option('d', "device",
+                        "Device mode. Can be Serial, OpenMP, OpenCL, CUDA, HIP, or SYCL (default: Serial)")
+      .withArg()
+      .withDefaultValue("Serial")
+    )
+    .addOption(
+      occa::cli::option('f', "file",
+                        "Raw binary file of doubles to reduce. If not given, a file of random data is generated")
+      .withArg()
+      .withDefaultValue("")
+    )
+    .addOption(
+      occa::cli::option('n', "entries",
+                        "Vector length of the generated input file")
+      .withArg()
+      .withDefaultValue("10000000")
+    )
+    .addOption(
+      occa::cli::option('c', "chunk",
+                        "Entries per streamed chunk")
+      .withArg()
+      .withDefaultValue("1048576")
+    )
+    .addOption(
+      occa::cli::option('s', "streams",
+                        "Number of pinned host buffers and streams in the ring")
+      .withArg()
+      .withDefaultValue("3")
+    );
+
+  occa::json args = parser.parseArgs(argc, argv);
+  return args;
+}
+
+// Write a file of random doubles to stream through the reduction
+void generateInput(const std::string &filename, const size_t entries) {
+  std::ofstream file(filename, std::ios::binary);
+
+  std::mt19937 gen(0);
+  std::uniform_real_distribution<double> dist(-1, 1);
+
+  std::vector<double> block(1 << 16);
+  size_t written = 0;
+  while (written < entries) {
+    const size_t count = std::min(block.size(), entries - written);
+    for (size_t i = 0; i < count; ++i) {
+      block[i] = dist(gen);
+    }
+    file.write(reinterpret_cast<const char*>(block.data()), count * sizeof(double));
+    written += count;
+  }
+}
+
+int main(int argc, const char **argv) {
+
+  // Parse arguments to json
+  occa::json args = parseArgs(argc, argv);
+
+  std::string mode;
+  if (args["options/device"]=="Serial") {
+    mode = "{mode: 'Serial'}";
+  } else if (args["options/device"]=="OpenMP") {
+    mode = "{mode: 'OpenMP'}";
+  } else if (args["options/device"]=="OpenCL") {
+    mode = "{mode: 'OpenCL', platform_id: 0, device_id: 0}";
+  } else if (args["options/device"]=="CUDA") {
+    mode = "{mode: 'CUDA', device_id: 0}";
+  } else if (args["options/device"]=="HIP") {
+    mode = "{mode: 'HIP', device_id: 0}";
+  } else if (args["options/device"]=="SYCL") {
+    mode = "{mode: 'SYCL', device_id: 0}";
+  }
+  // Create & setup occa::device
+  occa::device device(mode);
+
+  const int maxBlocks = 512;
+  const int blockSize = 256;
+
+  // Checked before any input file is generated
+  const int chunkEntries = std::stoi(args["options/chunk"]);
+  const int Nstreams     = std::stoi(args["options/streams"]);
+  if (chunkEntries < 1 || Nstreams < 1) {
+    std::cout << "--chunk and --streams must be at least 1" << std::endl;
+    throw 1;
+  }
+
+  std::string filename = args["options/file"];
+  const bool generated = filename.empty();
+  if (generated) {
+    filename = "07_Streaming_Reduction_input.bin";
+    generateInput(filename, std::stoul(args["options/entries"]));
+  }
+
+  /*
+  Map the input file into the address space instead of reading it
+  into a host vector. Pages are only faulted in from disk when they are
+  touched, so the dataset can be far larger than both host and device
+  memory. MADV_SEQUENTIAL lets the kernel read ahead aggressively and
+  drop pages behind us.
+  */
+  const int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    std::cout << "Unable to open " << filename << std::endl;
+    throw 1;
+  }
+  struct stat fileStat;
+  if (fstat(fd, &fileStat) != 0) {
+    std::cout << "Unable to stat " << filename << std::endl;
+    throw 1;
+  }
+  const size_t fileBytes = fileStat.st_size;
+  if (fileBytes == 0 || fileBytes % sizeof(double) != 0) {
+    std::cout << filename << " is not a non-empty file of doubles ("
+              << fileBytes << " bytes)" << std::endl;
+    throw 1;
+  }
+  const size_t entries = fileBytes / sizeof(double);
+
+  /*
+  A file that was just written, like the generated one, still sits in the
+  page cache, and streaming it would measure memory bandwidth instead of
+  the disk. Write back any dirty pages and ask the kernel to drop the
+  file's pages, so the timed run has to read it from disk.
+  */
+  const bool dropped = (fsync(fd) == 0)
+                    && (posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0);
+
+  void *mapping = mmap(nullptr, fileBytes, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (mapping == MAP_FAILED) {
+    std::cout << "Unable to mmap " << filename << std::endl;
+    throw 1;
+  }
+  madvise(mapping, fileBytes, MADV_SEQUENTIAL);
+  const double *x = static_cast<const double*>(mapping);
+
+  const int Nchunks      = (entries + chunkEntries - 1) / chunkEntries;
+
+  /*
+  Each slot of the ring owns a pinned host staging buffer, a device
+  buffer, reduction scratch space, and a stream. While one slot's chunk
+  is being copied and reduced on its stream, the host is already paging
+  the next chunk in from disk into another slot's staging buffer.
+  */
+  std::vector<occa::memory> h_chunk(Nstreams);
+  std::vector<occa::memory> o_chunk(Nstreams);
+  std::vector<occa::memory> o_scratch(Nstreams);
+  std::vector<occa::stream> streams(Nstreams);
+  for (int r = 0; r < Nstreams; ++r) {
+    h_chunk[r]   = device.malloc<double>(chunkEntries, occa::json("host", true));
+    o_chunk[r]   = device.malloc<double>(chunkEntries);
+    o_scratch[r] = device.malloc<double>(maxBlocks);
+    streams[r]   = (r == 0) ? device.getStream() : device.createStream();
+  }
+
+  /*
+  One partial sum per chunk. Partial results stay on the device and are
+  carried forward to a final reduction, so nothing is copied back to the
+  host until the whole file has been consumed.
+  */
+  occa::memory o_partials = device.malloc<double>(Nchunks);
+  occa::memory o_sum = device.malloc<double>(1);
+  occa::memory h_sum = device.malloc<double>(1, occa::json("host", true));
+
+  occa::json properties;
+  properties["defines"].asObject();
+
+  properties["defines/MAX_BLOCKS"] = maxBlocks;
+  properties["defines/BLOCK_SIZE"] = blockSize;
+
+  occa::kernel sumKernel = device.buildKernel(
+                                    OCCA_BUILD_DIR "/03_Reduction/sum.okl",
+                                    "sum",
+                                    properties
+                                   );
+
+  const size_t pageSize = sysconf(_SC_PAGESIZE);
+
+  double readTime = 0.0;
+  auto start = std::chrono::steady_clock::now();
+
+  for (int c = 0; c < Nchunks; ++c) {
+    const int r = c % Nstreams;
+    const size_t offset = static_cast<size_t>(c) * chunkEntries;
+    const int N = std::min<size_t>(chunkEntries, entries - offset);
+
+    // Ask the OS to start reading the chunk this slot will need next time around
+    const size_t ahead = offset + static_cast<size_t>(Nstreams) * chunkEntries;
+    if (ahead < entries) {
+      const size_t aheadBytes = ahead * sizeof(double);
+      const size_t pageStart  = aheadBytes - aheadBytes % pageSize;
+      const size_t length     = std::min<size_t>(chunkEntries, entries - ahead) * sizeof(double);
+      madvise(static_cast<char*>(mapping) + pageStart,
+              length + (aheadBytes - pageStart), MADV_WILLNEED);
+    }
+
+    /*
+    Before overwriting this slot's staging buffer, the async copy that
+    last read from it must have completed
+    */
+    device.setStream(streams[r]);
+    device.finish();
+
+    auto readStart = std::chrono::steady_clock::now();
+    std::memcpy(h_chunk[r].ptr(), x + offset, N * sizeof(double));
+    readTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - readStart).count();
+
+    // Queue the transfer and the reduction of this chunk on the slot's stream
+    o_chunk[r].copyFrom(h_chunk[r],
+                        /*Nbytes*/N * sizeof(double),
+                        /*Offset*/0,
+                        /*Async*/ occa::json("async", true));
+
+    const int Nblocks = (N < maxBlocks) ? N : maxBlocks;
+    sumKernel(N, Nblocks, o_chunk[r], o_scratch[r], o_partials.slice(c, 1));
+  }
+
+  // Wait for every stream in the ring to drain
+  for (int r = 0; r < Nstreams; ++r) {
+    device.setStream(streams[r]);
+    device.finish();
+  }
+
+  // Reduce the per-chunk partial sums to the final value
+  device.setStream(streams[0]);
+  const int Nblocks = (Nchunks < maxBlocks) ? Nchunks : maxBlocks;
+  sumKernel(Nchunks, Nblocks, o_partials, o_scratch[0], o_sum);
+
+  h_sum.copyFrom(o_sum,
+                 /*Nbytes*/sizeof(double),
+                 /*Offset*/0,
+                 /*Async*/ occa::json("async", true));
+  device.finish();
+
+  const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  const double sum = *(static_cast<double*>(h_sum.ptr()));
+
+  std::cout << "Streamed " << fileBytes / 1.0E9 << " GB in "
+            << Nchunks << " chunks over " << Nstreams << " streams" << std::endl;
+  std::cout << "  Elapsed:        " << elapsed << " s" << std::endl;
+  std::cout << "  Host read time: " << readTime << " s" << std::endl;
+  std::cout << (dropped ? "  Disk to result: " : "  Cached file to result (could not drop the page cache): ")
+            << fileBytes / elapsed / 1.0E9 << " GB/s" << std::endl;
+
+  /*Compute reference sum*/
+  double sumRef = 0.0;
+  double absRef = 0.0;
+  for (size_t i = 0; i < entries; ++i) {
+    sumRef += x[i];
+    absRef += std::abs(x[i]);
+  }
+
+  munmap(mapping, fileBytes);
+  close(fd);
+  if (generated) {
+    std::remove(filename.c_str());
+  }
+
+  // Check correctness, allowing for the different summation order
+  if (std::abs(sum-sumRef) > 1.0E-12 * absRef + 1.0E-12) {
+    std::cout << "FAILED" << std::endl;
+    throw 1;
+  }
+  std::cout << "PASSED!" << std::endl;
+  return 0;
+}
@@ -0,0 +1,382 @@
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <chrono>
+
+#include <occa.hpp>
+
+//---[ Internal Tools ]-----------------
+// Note: These headers are not officially supported
+//       Please don't rely on it outside of the occa examples
+#include <occa/internal/utils/cli.hpp>
+#include <occa/internal/utils/testing.hpp>
+//======================================
+
+#include "multiDevice.hpp"
+
+occa::json parseArgs(int argc, const char **argv) {
+  occa::cli::parser parser;
+  parser
+    .withDescription(
+      "Splitting work across multiple devices"
+    )
+    .addOption(
+      occa::cli::option('d', "device",
+                        "Device mode. Can be Serial, OpenMP, OpenCL, CUDA, HIP, or SYCL (default: Serial)")
+      .withArg()
+      .withDefaultValue("Serial")
+    )
+    .addOption(
+      occa::cli::option('D', "devices",
+                        "Number of devices to split work across. For Serial and OpenMP, each device "
+                        "is pinned to its own NUMA domain, or an equal share of the cores")
+      .withArg()
+      .withDefaultValue("2")
+    )
+    .addOption(
+      occa::cli::option('t', "threads-per-device",
+                        "OpenMP threads per device (default: the CPUs of the device's domain)")
+      .withArg()
+      .withDefaultValue("0")
+    )
+    .addOption(
+      occa::cli::option('n', "entries",
+                        "Vector length")
+      .withArg()
+      .withDefaultValue("10000000")
+    )
+    .addOption(
+      occa::cli::option('M', "dimM",
+                        "Matrix Rows")
+      .withArg()
+      .withDefaultValue("512")
+    )
+    .addOption(
+      occa::cli::option('N', "dimN",
+                        "Matrix Columns")
+      .withArg()
+      .withDefaultValue("512")
+    )
+    .addOption(
+      occa::cli::option('K', "dimK",
+                        "Matrix contraction dimension")
+      .withArg()
+      .withDefaultValue("512")
+    )
+    .addOption(
+      occa::cli::option('i', "iterations",
+                        "Timed iterations per kernel")
+      .withArg()
+      .withDefaultValue("10")
+    );
+
+  occa::json args = parser.parseArgs(argc, argv);
+  return args;
+}
+
+typedef std::chrono::steady_clock timer;
+
+double elapsedSince(const timer::time_point start) {
+  return std::chrono::duration<double>(timer::now() - start).count();
+}
+
+// Element-wise add, with the vectors partitioned by range
+double runAddVectors(multiDevice &devices,
+                     const std::vector<float> &a,
+                     const std::vector<float> &b,
+                     std::vector<float> &ab,
+                     const int iterations) {
+  const int entries = a.size();
+  const std::vector<int> offsets = devices.partition(entries);
+
+  std::vector<occa::kernel> addVectors = devices.buildKernel(
+                                    OCCA_BUILD_DIR "/01_Introduction/addVectors.okl",
+                                    "addVectors");
+
+  std::vector<occa::memory> o_a(devices.size());
+  std::vector<occa::memory> o_b(devices.size());
+  std::vector<occa::memory> o_ab(devices.size());
+
+  // Allocated and filled by each device's worker, so pages are first touched on its domain
+  devices.forEach([&](const int d) {
+    const int n = offsets[d+1] - offsets[d];
+    o_a[d]  = devices[d].malloc<float>(n, a.data() + offsets[d]);
+    o_b[d]  = devices[d].malloc<float>(n, b.data() + offsets[d]);
+    o_ab[d] = devices[d].malloc<float>(n);
+  });
+
+  auto launch = [&](const int d) {
+    addVectors[d](offsets[d+1] - offsets[d], o_a[d], o_b[d], o_ab[d]);
+    devices[d].finish();
+  };
+
+  // Warm up
+  devices.forEach(launch);
+
+  auto start = timer::now();
+  for (int it = 0; it < iterations; ++it) {
+    devices.forEach(launch);
+  }
+  const double elapsed = elapsedSince(start) / iterations;
+
+  // Gather each device's range back into the host vector
+  devices.forEach([&](const int d) {
+    o_ab[d].copyTo(ab.data() + offsets[d]);
+  });
+  return elapsed;
+}
+
+// GEMM, with C (and B) partitioned into blocks of columns
+double runMatrixMultiply(multiDevice &devices,
+                         const int M, const int N, const int K,
+                         const std::vector<float> &A,
+                         const std::vector<float> &B,
+                         std::vector<float> &C,
+                         const int iterations) {
+  const int LDA = M;
+  const int LDB = K;
+  const int LDC = M;
+  const std::vector<int> offsets = devices.partition(N);
+
+  occa::json properties;
+  properties["defines"].asObject();
+  properties["defines/N_TILE_SIZE"] = 16;
+  properties["defines/M_TILE_SIZE"] = 16;
+
+  std::vector<occa::kernel> matrixMultiply = devices.buildKernel(
+                                    OCCA_BUILD_DIR "/02_Loops/matrixMultiply.okl",
+                                    "matrixMultiply",
+                                    properties);
+
+  // Every device needs all of A, but only its own columns of B and C
+  std::vector<occa::memory> o_A(devices.size());
+  std::vector<occa::memory> o_B(devices.size());
+  std::vector<occa::memory> o_C(devices.size());
+  devices.forEach([&](const int d) {
+    const int n = offsets[d+1] - offsets[d];
+    o_A[d] = devices[d].malloc<float>(K * LDA, A.data());
+    o_B[d] = devices[d].malloc<float>(n * LDB, B.data() + offsets[d] * LDB);
+    o_C[d] = devices[d].malloc<float>(n * LDC);
+  });
+
+  auto launch = [&](const int d) {
+    matrixMultiply[d](offsets[d+1] - offsets[d], M, K,
+                      o_A[d], LDA,
+                      o_B[d], LDB,
+                      o_C[d], LDC);
+    devices[d].finish();
+  };
+
+  // Warm up
+  devices.forEach(launch);
+
+  auto start = timer::now();
+  for (int it = 0; it < iterations; ++it) {
+    devices.forEach(launch);
+  }
+  const double elapsed = elapsedSince(start) / iterations;
+
+  devices.forEach([&](const int d) {
+    o_C[d].copyTo(C.data() + offsets[d] * LDC);
+  });
+  return elapsed;
+}
+
+/*
+Sum reduction, combined hierarchically: the sum kernel reduces each
+device's range through its block tree, then the per-device partial sums
+are combined pairwise on the host
+*/
+double runSum(multiDevice &devices,
+              const std::vector<double> &x,
+              double &sum,
+              const int iterations) {
+  const int maxBlocks = 512;
+  const int blockSize = 256;
+
+  const int entries = x.size();
+  const std::vector<int> offsets = devices.partition(entries);
+
+  occa::json properties;
+  properties["defines"].asObject();
+  properties["defines/MAX_BLOCKS"] = maxBlocks;
+  properties["defines/BLOCK_SIZE"] = blockSize;
+
+  std::vector<occa::kernel> sumKernel = devices.buildKernel(
+                                    OCCA_BUILD_DIR "/03_Reduction/sum.okl",
+                                    "sum",
+                                    properties);
+
+  std::vector<occa::memory> o_x(devices.size());
+  std::vector<occa::memory> o_scratch(devices.size());
+  std::vector<occa::memory> o_sum(devices.size());
+  devices.forEach([&](const int d) {
+    const int n = offsets[d+1] - offsets[d];
+    o_x[d]       = devices[d].malloc<double>(n, x.data() + offsets[d]);
+    o_scratch[d] = devices[d].malloc<double>(maxBlocks);
+    o_sum[d]     = devices[d].malloc<double>(1);
+  });
+
+  std::vector<double> partials(devices.size());
+
+  auto launch = [&](const int d) {
+    const int n = offsets[d+1] - offsets[d];
+    const int Nblocks = (n < maxBlocks) ? n : maxBlocks;
+    sumKernel[d](n, Nblocks, o_x[d], o_scratch[d], o_sum[d]);
+    o_sum[d].copyTo(&partials[d]);
+  };
+
+  // Warm up
+  devices.forEach(launch);
+  sum = treeCombine(partials);
+
+  auto start = timer::now();
+  for (int it = 0; it < iterations; ++it) {
+    devices.forEach(launch);
+    sum = treeCombine(partials);
+  }
+  return elapsedSince(start) / iterations;
+}
+
+void printScaling(const std::string &name,
+                  const int D,
+                  const double time1,
+                  const double timeD) {
+  const double speedup = time1 / timeD;
+  std::cout << std::left << std::setw(16) << name
+            << std::right << std::setw(14) << time1 * 1.0E3
+            << std::setw(14) << timeD * 1.0E3
+            << std::setw(10) << speedup
+            << std::setw(12) << 100.0 * speedup / D << "%" << std::endl;
+}
+
+int main(int argc, const char **argv) {
+
+  // Parse arguments to json
+  occa::json args = parseArgs(argc, argv);
+
+  const int D = std::stoi(args["options/devices"]);
+  const int threadsPerDevice = std::stoi(args["options/threads-per-device"]);
+
+  // Create some vectors and matrices in host memory
+  const int entries = std::stoi(args["options/entries"]);
+  const int M = std::stoi(args["options/dimM"]);
+  const int N = std::stoi(args["options/dimN"]);
+  const int K = std::stoi(args["options/dimK"]);
+
+  // Every device needs a non-empty range of the vectors and of the columns of C
+  if (D < 1 || D > entries || D > N) {
+    std::cout << "--devices must be between 1 and min(entries, dimN)" << std::endl;
+    throw 1;
+  }
+
+  /*
+  Each occa::device is independent, with its own memory, streams, and
+  kernels. GPU backends get one device per device_id; Serial and OpenMP
+  devices can be created several times on the same host.
+  */
+  std::vector<occa::device> deviceList(D);
+  for (int d = 0; d < D; ++d) {
+    const std::string id = std::to_string(d);
+
+    std::string mode;
+    if (args["options/device"]=="Serial") {
+      mode = "{mode: 'Serial'}";
+    } else if (args["options/device"]=="OpenMP") {
+      mode = "{mode: 'OpenMP'}";
+    } else if (args["options/device"]=="OpenCL") {
+      mode = "{mode: 'OpenCL', platform_id: 0, device_id: " + id + "}";
+    } else if (args["options/device"]=="CUDA") {
+      mode = "{mode: 'CUDA', device_id: " + id + "}";
+    } else if (args["options/device"]=="HIP") {
+      mode = "{mode: 'HIP', device_id: " + id + "}";
+    } else if (args["options/device"]=="SYCL") {
+      mode = "{mode: 'SYCL', device_id: " + id + "}";
+    }
+    deviceList[d].setup(mode);
+  }
+
+  /*
+  Host backends share the machine's cores, so pin each device to its own
+  domain. The single device baseline gets all of them.
+  */
+  const bool hostMode = (args["options/device"]=="Serial" || args["options/device"]=="OpenMP");
+  std::vector<std::vector<int>> domains1, domainsD;
+  if (hostMode) {
+    domains1 = hostDomains(1);
+    domainsD = hostDomains(D);
+  }
+
+  multiDevice single({deviceList[0]}, domains1);
+  multiDevice devices(deviceList, domainsD, threadsPerDevice);
+
+  const int iterations = std::stoi(args["options/iterations"]);
+
+  std::vector<float> a(entries);
+  std::vector<float> b(entries);
+  std::vector<double> x(entries);
+  std::vector<float> A(K * M);
+  std::vector<float> B(N * K);
+
+  std::mt19937 gen(0);
+  std::uniform_real_distribution<float> dist(-1, 1);
+
+  for (int i = 0; i < entries; ++i) {
+    a[i] = dist(gen);
+    b[i] = dist(gen);
+    x[i] = dist(gen);
+  }
+  for (float &v : A) v = dist(gen);
+  for (float &v : B) v = dist(gen);
+
+  std::vector<float> ab1(entries), abD(entries);
+  std::vector<float> C1(N * M), CD(N * M);
+  double sum1, sumD;
+
+  const double addTime1 = runAddVectors(single,  a, b, ab1, iterations);
+  const double addTimeD = runAddVectors(devices, a, b, abD, iterations);
+
+  const double gemmTime1 = runMatrixMultiply(single,  M, N, K, A, B, C1, iterations);
+  const double gemmTimeD = runMatrixMultiply(devices, M, N, K, A, B, CD, iterations);
+
+  const double sumTime1 = runSum(single,  x, sum1, iterations);
+  const double sumTimeD = runSum(devices, x, sumD, iterations);
+
+  std::cout << std::left << std::setw(16) << "kernel"
+            << std::right << std::setw(14) << "1 dev [ms]"
+            << std::setw(14) << (std::to_string(D) + " dev [ms]")
+            << std::setw(10) << "speedup"
+            << std::setw(13) << "efficiency" << std::endl;
+  printScaling("addVectors",     D, addTime1,  addTimeD);
+  printScaling("matrixMultiply", D, gemmTime1, gemmTimeD);
+  printScaling("sum",            D, sumTime1,  sumTimeD);
+
+  // Check correctness
+  for (int i = 0; i < entries; ++i) {
+    if (!occa::areBitwiseEqual(abD[i], a[i] + b[i])) {
+      std::cout << "FAILED" << std::endl;
+      throw 1;
+    }
+  }
+
+  // Each column of C is computed identically no matter which device owns it
+  for (int i = 0; i < N * M; ++i) {
+    if (!occa::areBitwiseEqual(CD[i], C1[i])) {
+      std::cout << "FAILED" << std::endl;
+      throw 1;
+    }
+  }
+
+  /*Compute reference sum*/
+  double sumRef = 0.0;
+  for (int i = 0; i < entries; ++i) {
+    sumRef += x[i];
+  }
+
+  if (std::abs(sumD-sumRef) > 1.0E-5 || std::abs(sum1-sumRef) > 1.0E-5) {
+    std::cout << "FAILED" << std::endl;
+    throw 1;
+  }
+  std::cout << "PASSED!" << std::endl;
+  return 0;
+}
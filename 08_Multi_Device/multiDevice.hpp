@@ -0,0 +1,272 @@
+#ifndef MULTI_DEVICE_HPP
+#define MULTI_DEVICE_HPP
+
+#include <condition_variable>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <occa.hpp>
+
+// Parses a sysfs cpulist such as "0-15,32-47"
+inline std::vector<int> parseCpuList(const std::string &list) {
+  std::vector<int> cpus;
+  std::stringstream ss(list);
+  std::string range;
+  while (std::getline(ss, range, ',')) {
+    const size_t dash = range.find('-');
+    const int first = std::stoi(range.substr(0, dash));
+    const int last = (dash == std::string::npos) ? first : std::stoi(range.substr(dash + 1));
+    for (int cpu = first; cpu <= last; ++cpu) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+/*
+Split the CPUs this process may run on into D host domains. With as many
+NUMA nodes as devices (or a multiple of it) each domain is one node (or a
+group of neighbouring nodes). Otherwise the CPUs are cut into D
+contiguous ranges. Returns no domains where affinity is not supported.
+*/
+inline std::vector<std::vector<int>> hostDomains(const int D) {
+  std::vector<std::vector<int>> domains;
+#ifdef __linux__
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+    return domains;
+  }
+
+  std::vector<std::vector<int>> nodes;
+  for (int node = 0; ; ++node) {
+    std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+    std::string list;
+    if (!(file >> list)) {
+      break;
+    }
+    std::vector<int> cpus;
+    for (const int cpu : parseCpuList(list)) {
+      if (CPU_ISSET(cpu, &allowed)) {
+        cpus.push_back(cpu);
+      }
+    }
+    if (!cpus.empty()) {
+      nodes.push_back(cpus);
+    }
+  }
+
+  if (!nodes.empty() && (nodes.size() % D == 0)) {
+    const int nodesPerDomain = nodes.size() / D;
+    domains.resize(D);
+    for (size_t node = 0; node < nodes.size(); ++node) {
+      std::vector<int> &domain = domains[node / nodesPerDomain];
+      domain.insert(domain.end(), nodes[node].begin(), nodes[node].end());
+    }
+    return domains;
+  }
+
+  std::vector<int> cpus;
+  for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+    if (CPU_ISSET(cpu, &allowed)) {
+      cpus.push_back(cpu);
+    }
+  }
+  if ((int) cpus.size() < D) {
+    return domains;
+  }
+  domains.resize(D);
+  for (int d = 0; d < D; ++d) {
+    const size_t begin = (cpus.size() * d) / D;
+    const size_t end = (cpus.size() * (d + 1)) / D;
+    domains[d].assign(cpus.begin() + begin, cpus.begin() + end);
+  }
+#endif
+  return domains;
+}
+
+/*
+A small executor over a list of occa::devices. Work is split into
+contiguous ranges, one per device, and each device's share is run by its
+own persistent host thread. Kernel launches are synchronous in Serial
+and OpenMP modes, so a host thread per device is what lets several such
+devices run concurrently on one machine. For async backends the threads
+only queue work, and finish() waits for all of it.
+
+For host backends, pass the CPU domains from hostDomains(). Each worker
+is then pinned to its domain and sets its OpenMP team to the domain's
+CPU count (or threadsPerDevice), so D devices share the cores instead of
+each starting a full-size team. OpenMP threads inherit the affinity of
+the worker that starts them. Memory allocated and initialized inside
+forEach() is first touched by that worker, and so lands on its domain's
+NUMA node.
+*/
+class multiDevice {
+ public:
+  multiDevice(const std::vector<occa::device> &devices_,
+              const std::vector<std::vector<int>> &domains_ = {},
+              const int threadsPerDevice_ = 0) :
+    devices(devices_),
+    domains(domains_),
+    threadsPerDevice(threadsPerDevice_) {
+    for (int d = 0; d < size(); ++d) {
+      workers.emplace_back(&multiDevice::workerLoop, this, d);
+    }
+  }
+
+  ~multiDevice() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread &worker : workers) {
+      worker.join();
+    }
+  }
+
+  multiDevice(const multiDevice &) = delete;
+  multiDevice& operator = (const multiDevice &) = delete;
+
+  int size() const {
+    return static_cast<int>(devices.size());
+  }
+
+  occa::device& operator [] (const int d) {
+    return devices[d];
+  }
+
+  /*
+  Split [0, N) into size() contiguous ranges of near-equal length.
+  Device d owns [offsets[d], offsets[d+1]).
+  */
+  std::vector<int> partition(const int N) const {
+    const int D = size();
+    std::vector<int> offsets(D + 1);
+    for (int d = 0; d <= D; ++d) {
+      offsets[d] = static_cast<int>((static_cast<long long>(N) * d) / D);
+    }
+    return offsets;
+  }
+
+  // Build the same kernel on every device
+  std::vector<occa::kernel> buildKernel(const std::string &filename,
+                                        const std::string &kernelName,
+                                        const occa::json &props = occa::json()) {
+    std::vector<occa::kernel> kernels(size());
+    for (int d = 0; d < size(); ++d) {
+      kernels[d] = devices[d].buildKernel(filename, kernelName, props);
+    }
+    return kernels;
+  }
+
+  // Run func(d) on every device's worker concurrently and wait for all to return
+  void forEach(const std::function<void(int)> &func) {
+    std::unique_lock<std::mutex> lock(mutex);
+    task = func;
+    pending = size();
+    ++generation;
+    wake.notify_all();
+    done.wait(lock, [&]() { return pending == 0; });
+  }
+
+  // Wait for the queued work on every device's current stream
+  void finish() {
+    forEach([&](const int d) {
+      devices[d].finish();
+    });
+  }
+
+ private:
+  std::vector<occa::device> devices;
+  std::vector<std::vector<int>> domains;
+  int threadsPerDevice;
+
+  std::vector<std::thread> workers;
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::condition_variable done;
+  std::function<void(int)> task;
+  long generation = 0;
+  int pending = 0;
+  bool stopping = false;
+
+  // Pin the calling worker to its domain and size its OpenMP team
+  void bindWorker(const int d) {
+    int threads = threadsPerDevice;
+#ifdef __linux__
+    if (d < (int) domains.size()) {
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      for (const int cpu : domains[d]) {
+        CPU_SET(cpu, &set);
+      }
+      pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+      if (threads <= 0) {
+        threads = domains[d].size();
+      }
+    }
+#endif
+#ifdef _OPENMP
+    if (threads > 0) {
+      omp_set_num_threads(threads);
+    }
+#endif
+  }
+
+  void workerLoop(const int d) {
+    bindWorker(d);
+
+    long seen = 0;
+    while (true) {
+      std::function<void(int)> job;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        wake.wait(lock, [&]() { return stopping || generation != seen; });
+        if (stopping) {
+          return;
+        }
+        seen = generation;
+        job = task;
+      }
+
+      job(d);
+
+      std::lock_guard<std::mutex> lock(mutex);
+      if (--pending == 0) {
+        done.notify_all();
+      }
+    }
+  }
+};
+
+/*
+Combine one value per device pairwise, in a fixed order, so the result
+does not depend on which device finished first. This is the last level of
+the hierarchical sum: blocks within a device, then devices.
+*/
+template <class T>
+T treeCombine(std::vector<T> values) {
+  for (size_t stride = 1; stride < values.size(); stride *= 2) {
+    for (size_t d = 0; d + stride < values.size(); d += 2 * stride) {
+      values[d] += values[d + stride];
+    }
+  }
+  return values.empty() ? T() : values[0];
+}
+
+#endif
@@ -0,0 +1,244 @@
+#include <iostream>
+#include <iomanip>
+#include <random>
+
+#include <occa.hpp>
+
+//---[ Internal Tools ]-----------------
+// Note: These headers are not officially supported
+//       Please don't rely on it outside of the occa examples
+#include <occa/internal/utils/cli.hpp>
+#include <occa/internal/utils/testing.hpp>
+//======================================
+
+#include "sparseMatrix.hpp"
+
+occa::json parseArgs(int argc, const char **argv) {
+  occa::cli::parser parser;
+  parser
+    .withDescription(
+      "Sparse matrix-vector product kernels"
+    )
+    .addOption(
+      occa::cli::option('d', "device",
+                        "Device mode. Can be Serial, OpenMP, OpenCL, CUDA, HIP, or SYCL (default: Serial)")
+      .withArg()
+      .withDefaultValue("Serial")
+    )
+    .addOption(
+      occa::cli::option('n', "rows",
+                        "Rows in the generated matrices")
+      .withArg()
+      .withDefaultValue("1000000")
+    )
+    .addOption(
+      occa::cli::option('f', "file",
+                        "Matrix Market file to add to the benchmark suite")
+      .withArg()
+      .withDefaultValue("")
+    )
+    .addOption(
+      occa::cli::option('i', "iterations",
+                        "Timed iterations per kernel")
+      .withArg()
+      .withDefaultValue("20")
+    );
+
+  occa::json args = parser.parseArgs(argc, argv);
+  return args;
+}
+
+// ELLPACK is skipped when padding would grow storage past this factor of nnz
+const double maxEllPadding = 4.0;
+
+/*
+Time a number of launches between two stream tags. Tags are recorded in
+the device's current stream, so on async backends this measures device
+execution, not just the time to queue the launches.
+*/
+template <class Launch>
+double timeKernel(occa::device &device, const int iterations, Launch launch) {
+  // Warm up
+  launch();
+
+  occa::streamTag start = device.tagStream();
+  for (int it = 0; it < iterations; ++it) {
+    launch();
+  }
+  occa::streamTag end = device.tagStream();
+  device.waitFor(end);
+  return device.timeBetween(start, end) / iterations;
+}
+
+bool checkResult(occa::memory &o_y,
+                 const std::vector<double> &yRef,
+                 const double tolerance) {
+  std::vector<double> y(yRef.size());
+  o_y.copyTo(y.data());
+  for (size_t r = 0; r < y.size(); ++r) {
+    if (std::abs(y[r] - yRef[r]) > tolerance) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void printRate(const double flops, const double bytes, const double time, const bool selected) {
+  std::cout << std::setw(9) << std::fixed << std::setprecision(2) << flops / time / 1.0E9
+            << std::setw(8) << bytes / time / 1.0E9
+            << (selected ? "*" : " ");
+}
+
+int main(int argc, const char **argv) {
+
+  // Parse arguments to json
+  occa::json args = parseArgs(argc, argv);
+
+  std::string mode;
+  if (args["options/device"]=="Serial") {
+    mode = "{mode: 'Serial'}";
+  } else if (args["options/device"]=="OpenMP") {
+    mode = "{mode: 'OpenMP'}";
+  } else if (args["options/device"]=="OpenCL") {
+    mode = "{mode: 'OpenCL', platform_id: 0, device_id: 0}";
+  } else if (args["options/device"]=="CUDA") {
+    mode = "{mode: 'CUDA', device_id: 0}";
+  } else if (args["options/device"]=="HIP") {
+    mode = "{mode: 'HIP', device_id: 0}";
+  } else if (args["options/device"]=="SYCL") {
+    mode = "{mode: 'SYCL', device_id: 0}";
+  }
+  // Create & setup occa::device
+  occa::device device(mode);
+
+  const int blockSize = 256;
+  const int iterations = std::stoi(args["options/iterations"]);
+  const int Nrows = std::stoi(args["options/rows"]);
+
+  // Matrices with different row length profiles
+  std::vector<csrMatrix> suite;
+  suite.push_back(laplacian2D(static_cast<int>(std::sqrt(Nrows))));
+  suite.push_back(randomUniform("uniform8", Nrows, 8, 8));
+  suite.push_back(randomUniform("variable64", Nrows / 16, 16, 112));
+  suite.push_back(randomPowerLaw(Nrows));
+
+  const std::string filename = args["options/file"];
+  if (!filename.empty()) {
+    csrMatrix A = readMatrixMarket(filename);
+    if (A.Nrows == 0) {
+      std::cout << "Unable to read Matrix Market file " << filename << std::endl;
+      throw 1;
+    }
+    suite.push_back(std::move(A));
+  }
+
+  std::cout << "GFLOP/s and effective GB/s per kernel, * marks the format chosen by the heuristic" << std::endl;
+  std::cout << std::left << std::setw(14) << "matrix"
+            << std::right << std::setw(10) << "rows"
+            << std::setw(11) << "nnz"
+            << std::setw(8) << "mean"
+            << std::setw(8) << "stddev"
+            << std::setw(8) << "max"
+            << std::setw(18) << "csrScalar"
+            << std::setw(18) << "csrVector"
+            << std::setw(18) << "ell" << std::endl;
+
+  bool passed = true;
+
+  for (const csrMatrix &A : suite) {
+    const rowStatistics stats = rowLengthStatistics(A);
+    const spmvFormat format = selectFormat(stats);
+    const int vectorSize = selectVectorSize(stats);
+
+    std::vector<double> x(A.Ncols);
+    std::vector<double> yRef(A.Nrows);
+
+    std::mt19937 gen(0);
+    std::uniform_real_distribution<double> dist(-1, 1);
+    for (double &v : x) v = dist(gen);
+
+    spmvReference(A, x, yRef);
+
+    // Allow for the different summation order of the vector kernel
+    double tolerance = 0.0;
+    for (double v : A.vals) tolerance += std::abs(v);
+    tolerance *= 1.0E-14;
+
+    occa::memory o_rowStarts = device.malloc<int>(A.Nrows + 1, A.rowStarts.data());
+    occa::memory o_cols      = device.malloc<int>(A.nnz(), A.cols.data());
+    occa::memory o_vals      = device.malloc<double>(A.nnz(), A.vals.data());
+    occa::memory o_x         = device.malloc<double>(A.Ncols, x.data());
+    occa::memory o_y         = device.malloc<double>(A.Nrows);
+
+    occa::json properties;
+    properties["defines"].asObject();
+    properties["defines/BLOCK_SIZE"] = blockSize;
+
+    // The vector kernel's group size is a compile-time constant
+    properties["defines/VECTOR_SIZE"] = vectorSize;
+    properties["defines/ROWS_PER_BLOCK"] = blockSize / vectorSize;
+
+    occa::kernel spmvCsrScalar = device.buildKernel(
+                                    OCCA_BUILD_DIR "/09_Sparse_Matrix_Vector/spmv.okl",
+                                    "spmvCsrScalar",
+                                    properties);
+    occa::kernel spmvCsrVector = device.buildKernel(
+                                    OCCA_BUILD_DIR "/09_Sparse_Matrix_Vector/spmv.okl",
+                                    "spmvCsrVector",
+                                    properties);
+    occa::kernel spmvEll       = device.buildKernel(
+                                    OCCA_BUILD_DIR "/09_Sparse_Matrix_Vector/spmv.okl",
+                                    "spmvEll",
+                                    properties);
+
+    const double flops = 2.0 * A.nnz();
+
+    // Every kernel must read x and write y at least once
+    const double vectorBytes = sizeof(double) * (A.Ncols + A.Nrows);
+    const double csrBytes = (sizeof(double) + sizeof(int)) * A.nnz()
+                          + sizeof(int) * (A.Nrows + 1) + vectorBytes;
+
+    std::cout << std::left << std::setw(14) << A.name
+              << std::right << std::setw(10) << A.Nrows
+              << std::setw(11) << A.nnz()
+              << std::setw(8) << std::fixed << std::setprecision(1) << stats.mean
+              << std::setw(8) << stats.stddev
+              << std::setw(8) << stats.max;
+
+    const double scalarTime = timeKernel(device, iterations, [&]() {
+      spmvCsrScalar(A.Nrows, o_rowStarts, o_cols, o_vals, o_x, o_y);
+    });
+    passed = passed && checkResult(o_y, yRef, tolerance);
+    printRate(flops, csrBytes, scalarTime, format == spmvFormat::csrScalar);
+
+    const double vectorTime = timeKernel(device, iterations, [&]() {
+      spmvCsrVector(A.Nrows, o_rowStarts, o_cols, o_vals, o_x, o_y);
+    });
+    passed = passed && checkResult(o_y, yRef, tolerance);
+    printRate(flops, csrBytes, vectorTime, format == spmvFormat::csrVector);
+
+    if (static_cast<double>(stats.max) * A.Nrows <= maxEllPadding * A.nnz()) {
+      const ellMatrix E = toEll(A);
+      occa::memory o_ellCols = device.malloc<int>(E.cols.size(), E.cols.data());
+      occa::memory o_ellVals = device.malloc<double>(E.vals.size(), E.vals.data());
+
+      const double ellBytes = (sizeof(double) + sizeof(int)) * E.vals.size() + vectorBytes;
+
+      const double ellTime = timeKernel(device, iterations, [&]() {
+        spmvEll(E.Nrows, E.width, o_ellCols, o_ellVals, o_x, o_y);
+      });
+      passed = passed && checkResult(o_y, yRef, tolerance);
+      printRate(flops, ellBytes, ellTime, format == spmvFormat::ell);
+    } else {
+      std::cout << std::setw(18) << "(too padded)";
+    }
+    std::cout << std::endl;
+  }
+
+  if (!passed) {
+    std::cout << "FAILED" << std::endl;
+    throw 1;
+  }
+  std::cout << "PASSED!" << std::endl;
+  return 0;
+}
@@ -0,0 +1,283 @@
+#ifndef SPARSE_MATRIX_HPP
+#define SPARSE_MATRIX_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// Sparse matrix in CSR (compressed sparse row) format
+struct csrMatrix {
+  std::string name;
+  int Nrows = 0;
+  int Ncols = 0;
+  std::vector<int> rowStarts;
+  std::vector<int> cols;
+  std::vector<double> vals;
+
+  int nnz() const {
+    return static_cast<int>(vals.size());
+  }
+};
+
+// Sparse matrix in ELLPACK format, stored column major
+struct ellMatrix {
+  int Nrows = 0;
+  int width = 0;
+  std::vector<int> cols;
+  std::vector<double> vals;
+};
+
+// Build a CSR matrix from (row, col, val) triplets. Duplicates are summed.
+inline csrMatrix fromTriplets(const std::string &name,
+                              const int Nrows, const int Ncols,
+                              std::vector<std::tuple<int, int, double>> triplets) {
+  std::sort(triplets.begin(), triplets.end(),
+            [](const std::tuple<int, int, double> &a,
+               const std::tuple<int, int, double> &b) {
+              return std::make_pair(std::get<0>(a), std::get<1>(a))
+                   < std::make_pair(std::get<0>(b), std::get<1>(b));
+            });
+
+  csrMatrix A;
+  A.name  = name;
+  A.Nrows = Nrows;
+  A.Ncols = Ncols;
+  A.rowStarts.assign(Nrows + 1, 0);
+
+  for (size_t i = 0; i < triplets.size(); ++i) {
+    const int row = std::get<0>(triplets[i]);
+    const int col = std::get<1>(triplets[i]);
+    if (!A.cols.empty() && i > 0
+        && std::get<0>(triplets[i-1]) == row && A.cols.back() == col) {
+      A.vals.back() += std::get<2>(triplets[i]);
+      continue;
+    }
+    A.cols.push_back(col);
+    A.vals.push_back(std::get<2>(triplets[i]));
+    ++A.rowStarts[row + 1];
+  }
+  for (int r = 0; r < Nrows; ++r) {
+    A.rowStarts[r + 1] += A.rowStarts[r];
+  }
+  return A;
+}
+
+/*
+Load a Matrix Market coordinate file. Supports real, integer, and pattern
+fields with general, symmetric, or skew-symmetric storage. Returns a
+matrix with Nrows == 0 if the file cannot be read, is truncated, or has
+an index out of range.
+*/
+inline csrMatrix readMatrixMarket(const std::string &filename) {
+  std::ifstream file(filename);
+  std::string line;
+  if (!file || !std::getline(file, line)) {
+    return csrMatrix();
+  }
+
+  std::string banner, object, format, field, symmetry;
+  std::istringstream header(line);
+  header >> banner >> object >> format >> field >> symmetry;
+  for (std::string *s : {&object, &format, &field, &symmetry}) {
+    std::transform(s->begin(), s->end(), s->begin(), ::tolower);
+  }
+  if (banner != "%%MatrixMarket" || object != "matrix" || format != "coordinate"
+      || (field != "real" && field != "integer" && field != "pattern")
+      || (symmetry != "general" && symmetry != "symmetric" && symmetry != "skew-symmetric")) {
+    return csrMatrix();
+  }
+  const bool pattern = (field == "pattern");
+  const bool mirror  = (symmetry != "general");
+  // Skew-symmetric files store the lower triangle of A = -A^T
+  const double mirrorSign = (symmetry == "skew-symmetric") ? -1.0 : 1.0;
+
+  // Skip comments and blank lines
+  while (std::getline(file, line)
+         && (line.find_first_not_of(" \t\r") == std::string::npos || line[0] == '%')) {}
+
+  int Nrows = 0, Ncols = 0, entries = 0;
+  std::istringstream sizes(line);
+  if (!(sizes >> Nrows >> Ncols >> entries)
+      || Nrows <= 0 || Ncols <= 0 || entries < 0
+      || (mirror && Nrows != Ncols)) {
+    return csrMatrix();
+  }
+
+  std::vector<std::tuple<int, int, double>> triplets;
+  triplets.reserve(mirror ? 2 * (size_t) entries : entries);
+  for (int i = 0; i < entries; ++i) {
+    int row, col;
+    double val = 1.0;
+    if (!(file >> row >> col) || (!pattern && !(file >> val))) {
+      return csrMatrix();
+    }
+    // Matrix Market indices are 1-based
+    if (row < 1 || row > Nrows || col < 1 || col > Ncols) {
+      return csrMatrix();
+    }
+    triplets.emplace_back(row - 1, col - 1, val);
+    if (mirror && row != col) {
+      triplets.emplace_back(col - 1, row - 1, mirrorSign * val);
+    }
+  }
+
+  const size_t slash = filename.find_last_of('/');
+  return fromTriplets(filename.substr(slash == std::string::npos ? 0 : slash + 1),
+                      Nrows, Ncols, std::move(triplets));
+}
+
+//---[ Generated matrices ]-------------
+// 5-point Laplacian on an n x n grid: short, uniform rows
+inline csrMatrix laplacian2D(const int n) {
+  std::vector<std::tuple<int, int, double>> triplets;
+  for (int j = 0; j < n; ++j) {
+    for (int i = 0; i < n; ++i) {
+      const int row = i + j * n;
+      triplets.emplace_back(row, row, 4.0);
+      if (i > 0)     triplets.emplace_back(row, row - 1, -1.0);
+      if (i < n - 1) triplets.emplace_back(row, row + 1, -1.0);
+      if (j > 0)     triplets.emplace_back(row, row - n, -1.0);
+      if (j < n - 1) triplets.emplace_back(row, row + n, -1.0);
+    }
+  }
+  return fromTriplets("laplacian2D", n * n, n * n, std::move(triplets));
+}
+
+// Random columns with a row length drawn uniformly from [minLength, maxLength]
+inline csrMatrix randomUniform(const std::string &name,
+                               const int Nrows,
+                               const int minLength, const int maxLength) {
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<int> col(0, Nrows - 1);
+  std::uniform_int_distribution<int> length(minLength, maxLength);
+  std::uniform_real_distribution<double> val(-1, 1);
+
+  std::vector<std::tuple<int, int, double>> triplets;
+  triplets.reserve(static_cast<size_t>(Nrows) * maxLength);
+  for (int r = 0; r < Nrows; ++r) {
+    const int rowLength = length(gen);
+    for (int k = 0; k < rowLength; ++k) {
+      triplets.emplace_back(r, col(gen), val(gen));
+    }
+  }
+  return fromTriplets(name, Nrows, Nrows, std::move(triplets));
+}
+
+// Row lengths following a power law: mostly short rows with a few very long ones
+inline csrMatrix randomPowerLaw(const int Nrows) {
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<int> col(0, Nrows - 1);
+  std::uniform_real_distribution<double> val(-1, 1);
+  std::uniform_real_distribution<double> u(0, 1);
+
+  std::vector<std::tuple<int, int, double>> triplets;
+  for (int r = 0; r < Nrows; ++r) {
+    // Pareto distributed length with minimum 1 and exponent 1.5
+    const int rowLength = static_cast<int>(std::min<double>(Nrows, std::pow(1.0 - u(gen), -1.0 / 1.5)));
+    for (int k = 0; k < rowLength; ++k) {
+      triplets.emplace_back(r, col(gen), val(gen));
+    }
+  }
+  return fromTriplets("powerLaw", Nrows, Nrows, std::move(triplets));
+}
+//======================================
+
+inline ellMatrix toEll(const csrMatrix &A) {
+  ellMatrix E;
+  E.Nrows = A.Nrows;
+  for (int r = 0; r < A.Nrows; ++r) {
+    E.width = std::max(E.width, A.rowStarts[r+1] - A.rowStarts[r]);
+  }
+  E.cols.assign(static_cast<size_t>(E.width) * A.Nrows, -1);
+  E.vals.assign(static_cast<size_t>(E.width) * A.Nrows, 0.0);
+  for (int r = 0; r < A.Nrows; ++r) {
+    for (int j = A.rowStarts[r]; j < A.rowStarts[r+1]; ++j) {
+      const size_t id = r + static_cast<size_t>(j - A.rowStarts[r]) * A.Nrows;
+      E.cols[id] = A.cols[j];
+      E.vals[id] = A.vals[j];
+    }
+  }
+  return E;
+}
+
+struct rowStatistics {
+  double mean = 0.0;
+  double stddev = 0.0;
+  int max = 0;
+};
+
+inline rowStatistics rowLengthStatistics(const csrMatrix &A) {
+  rowStatistics stats;
+  if (A.Nrows == 0) {
+    return stats;
+  }
+  stats.mean = static_cast<double>(A.nnz()) / A.Nrows;
+  for (int r = 0; r < A.Nrows; ++r) {
+    const int length = A.rowStarts[r+1] - A.rowStarts[r];
+    stats.max = std::max(stats.max, length);
+    stats.stddev += (length - stats.mean) * (length - stats.mean);
+  }
+  stats.stddev = std::sqrt(stats.stddev / A.Nrows);
+  return stats;
+}
+
+enum class spmvFormat {
+  csrScalar,
+  csrVector,
+  ell
+};
+
+inline std::string toString(const spmvFormat format) {
+  switch (format) {
+    case spmvFormat::csrScalar: return "csrScalar";
+    case spmvFormat::csrVector: return "csrVector";
+    case spmvFormat::ell:       return "ell";
+  }
+  return "";
+}
+
+/*
+Pick a format from the row length statistics:
+ - ELLPACK when padding every row to the longest adds little storage,
+   i.e. the rows are nearly uniform
+ - vector CSR when rows are long enough to keep a group of threads busy
+ - scalar CSR otherwise
+*/
+inline spmvFormat selectFormat(const rowStatistics &stats) {
+  const double ellPadding = (stats.mean > 0) ? stats.max / stats.mean : 0.0;
+  if (ellPadding <= 1.5) {
+    return spmvFormat::ell;
+  }
+  if (stats.mean >= 12.0) {
+    return spmvFormat::csrVector;
+  }
+  return spmvFormat::csrScalar;
+}
+
+// Threads per row for vector CSR: the power of two nearest the mean row length, in [2, 32]
+inline int selectVectorSize(const rowStatistics &stats) {
+  int vectorSize = 2;
+  while (vectorSize < 32 && 1.5 * vectorSize < stats.mean) {
+    vectorSize *= 2;
+  }
+  return vectorSize;
+}
+
+inline void spmvReference(const csrMatrix &A,
+                          const std::vector<double> &x,
+                          std::vector<double> &y) {
+  for (int r = 0; r < A.Nrows; ++r) {
+    double r_y = 0.0;
+    for (int j = A.rowStarts[r]; j < A.rowStarts[r+1]; ++j) {
+      r_y += A.vals[j] * x[A.cols[j]];
+    }
+    y[r] = r_y;
+  }
+}
+
+#endif
@@ -0,0 +1,301 @@
+#include <iostream>
+#include <iomanip>
+#include <random>
+
+#include <occa.hpp>
+
+//---[ Internal Tools ]-----------------
+// Note: These headers are not officially supported
+//       Please don't rely on it outside of the occa examples
+#include <occa/internal/utils/cli.hpp>
+#include <occa/internal/utils/testing.hpp>
+//======================================
+
+occa::json parseArgs(int argc, const char **argv) {
+  occa::cli::parser parser;
+  parser
+    .withDescription(
+      "Stencil kernels with @shared tiling and temporal blocking"
+    )
+    .addOption(
+      occa::cli::option('d', "device",
+                        "Device mode. Can be Serial, OpenMP, OpenCL, CUDA, HIP, or SYCL (default: Serial)")
+      .withArg()
+      .withDefaultValue("Serial")
+    )
+    .addOption(
+      occa::cli::option('n', "n2d",
+                        "Grid points per side of the 2D grid")
+      .withArg()
+      .withDefaultValue("2048")
+    )
+    .addOption(
+      occa::cli::option('m', "n3d",
+                        "Grid points per side of the 3D grid")
+      .withArg()
+      .withDefaultValue("128")
+    )
+    .addOption(
+      occa::cli::option('s', "steps",
+                        "Jacobi sweeps. Rounded up to a multiple of the temporal block depth")
+      .withArg()
+      .withDefaultValue("32")
+    )
+    .addOption(
+      occa::cli::option('t', "tsteps",
+                        "Sweeps fused per memory pass in the temporal blocking kernel (1 to 15)")
+      .withArg()
+      .withDefaultValue("4")
+    );
+
+  occa::json args = parser.parseArgs(argc, argv);
+  return args;
+}
+
+/*
+Run launches of a stencil kernel, swapping input and output buffers
+after every launch. Returns the elapsed time; the result is left in o_u.
+*/
+template <class Launch>
+double runSweeps(occa::device &device,
+                 occa::memory &o_u,
+                 occa::memory &o_unew,
+                 const int launches,
+                 Launch launch) {
+  occa::streamTag start = device.tagStream();
+  for (int l = 0; l < launches; ++l) {
+    launch(o_u, o_unew);
+    std::swap(o_u, o_unew);
+  }
+  occa::streamTag end = device.tagStream();
+  device.waitFor(end);
+  return device.timeBetween(start, end);
+}
+
+// Host reference sweeps, with the same order of operations as the kernels
+void jacobi2dReference(const int Nx, const int Ny, const int steps, std::vector<double> &u) {
+  std::vector<double> unew(u);
+  for (int s = 0; s < steps; ++s) {
+    for (int j = 1; j < Ny-1; ++j) {
+      for (int i = 1; i < Nx-1; ++i) {
+        const int id = i + j * Nx;
+        unew[id] = 0.25 * (u[id-1] + u[id+1] + u[id-Nx] + u[id+Nx]);
+      }
+    }
+    std::swap(u, unew);
+  }
+}
+
+void jacobi3dReference(const int N, const int steps, std::vector<double> &u) {
+  std::vector<double> unew(u);
+  for (int s = 0; s < steps; ++s) {
+    for (int k = 1; k < N-1; ++k) {
+      for (int j = 1; j < N-1; ++j) {
+        for (int i = 1; i < N-1; ++i) {
+          const int id = i + j * N + k * N * N;
+          unew[id] = (u[id-1]   + u[id+1]
+                    + u[id-N]   + u[id+N]
+                    + u[id-N*N] + u[id+N*N]) / 6.0;
+        }
+      }
+    }
+    std::swap(u, unew);
+  }
+}
+
+bool checkResult(occa::memory &o_u, const std::vector<double> &uRef) {
+  std::vector<double> u(uRef.size());
+  o_u.copyTo(u.data());
+  for (size_t n = 0; n < u.size(); ++n) {
+    if (std::abs(u[n] - uRef[n]) > 1.0E-12) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void printRate(const std::string &name,
+               const double points,
+               const double time,
+               const double naiveTime) {
+  std::cout << std::left << std::setw(20) << name
+            << std::right << std::setw(12) << std::fixed << std::setprecision(3) << time * 1.0E3
+            << std::setw(14) << std::setprecision(2) << points / time / 1.0E9
+            << std::setw(10) << naiveTime / time << std::endl;
+}
+
+int main(int argc, const char **argv) {
+
+  // Parse arguments to json
+  occa::json args = parseArgs(argc, argv);
+
+  std::string mode;
+  if (args["options/device"]=="Serial") {
+    mode = "{mode: 'Serial'}";
+  } else if (args["options/device"]=="OpenMP") {
+    mode = "{mode: 'OpenMP'}";
+  } else if (args["options/device"]=="OpenCL") {
+    mode = "{mode: 'OpenCL', platform_id: 0, device_id: 0}";
+  } else if (args["options/device"]=="CUDA") {
+    mode = "{mode: 'CUDA', device_id: 0}";
+  } else if (args["options/device"]=="HIP") {
+    mode = "{mode: 'HIP', device_id: 0}";
+  } else if (args["options/device"]=="SYCL") {
+    mode = "{mode: 'SYCL', device_id: 0}";
+  }
+  // Create & setup occa::device
+  occa::device device(mode);
+
+  const int N2 = std::stoi(args["options/n2d"]);
+  const int N3 = std::stoi(args["options/n3d"]);
+  const int tsteps = std::stoi(args["options/tsteps"]);
+
+  /*
+  Each temporal block writes back TILE - 2*TSTEPS points per dimension,
+  which is also its @outer loop step, so the halo must leave some
+  interior
+  */
+  const int temporalTile = 32;
+  if (tsteps < 1 || 2 * tsteps >= temporalTile) {
+    std::cout << "--tsteps must be between 1 and " << (temporalTile - 1) / 2 << std::endl;
+    throw 1;
+  }
+
+  const int steps = ((std::stoi(args["options/steps"]) + tsteps - 1) / tsteps) * tsteps;
+
+  std::mt19937 gen(0);
+  std::uniform_real_distribution<double> dist(-1, 1);
+
+  /*
+  Tile sizes are compile-time constants so the @shared arrays can be
+  sized statically. The temporal blocking kernel needs a larger tile, since
+  a halo TSTEPS points wide is recomputed on each side.
+  */
+  occa::json properties2d;
+  properties2d["defines"].asObject();
+  properties2d["defines/TILE_X"] = 32;
+  properties2d["defines/TILE_Y"] = 8;
+  properties2d["defines/TILE_Z"] = 1;
+  properties2d["defines/TSTEPS"] = tsteps;
+
+  occa::json propertiesTemporal;
+  propertiesTemporal["defines"].asObject();
+  propertiesTemporal["defines/TILE_X"] = temporalTile;
+  propertiesTemporal["defines/TILE_Y"] = temporalTile;
+  propertiesTemporal["defines/TILE_Z"] = 1;
+  propertiesTemporal["defines/TSTEPS"] = tsteps;
+
+  occa::json properties3d;
+  properties3d["defines"].asObject();
+  properties3d["defines/TILE_X"] = 16;
+  properties3d["defines/TILE_Y"] = 4;
+  properties3d["defines/TILE_Z"] = 4;
+  properties3d["defines/TSTEPS"] = tsteps;
+
+  occa::kernel jacobi2dNaive = device.buildKernel(
+                                    OCCA_BUILD_DIR "/10_Stencils/stencil.okl",
+                                    "jacobi2dNaive",
+                                    properties2d);
+  occa::kernel jacobi2dTiled = device.buildKernel(
+                                    OCCA_BUILD_DIR "/10_Stencils/stencil.okl",
+                                    "jacobi2dTiled",
+                                    properties2d);
+  occa::kernel jacobi2dTemporal = device.buildKernel(
+                                    OCCA_BUILD_DIR "/10_Stencils/stencil.okl",
+                                    "jacobi2dTemporal",
+                                    propertiesTemporal);
+  occa::kernel jacobi3dNaive = device.buildKernel(
+                                    OCCA_BUILD_DIR "/10_Stencils/stencil.okl",
+                                    "jacobi3dNaive",
+                                    properties3d);
+  occa::kernel jacobi3dTiled = device.buildKernel(
+                                    OCCA_BUILD_DIR "/10_Stencils/stencil.okl",
+                                    "jacobi3dTiled",
+                                    properties3d);
+
+  bool passed = true;
+
+  std::cout << std::left << std::setw(20) << "kernel"
+            << std::right << std::setw(12) << "time [ms]"
+            << std::setw(14) << "Gpoints/s"
+            << std::setw(10) << "speedup" << std::endl;
+
+  //---[ 2D ]-----------------------------
+  {
+    std::vector<double> u0(N2 * N2);
+    for (double &v : u0) v = dist(gen);
+
+    std::vector<double> uRef(u0);
+    jacobi2dReference(N2, N2, steps, uRef);
+
+    const double points = static_cast<double>(N2 - 2) * (N2 - 2) * steps;
+
+    occa::memory o_u    = device.malloc<double>(N2 * N2, u0.data());
+    occa::memory o_unew = device.malloc<double>(N2 * N2, u0.data());
+
+    const double naiveTime = runSweeps(device, o_u, o_unew, steps,
+      [&](occa::memory &u, occa::memory &unew) {
+        jacobi2dNaive(N2, N2, u, unew);
+      });
+    passed = passed && checkResult(o_u, uRef);
+    printRate("jacobi2dNaive", points, naiveTime, naiveTime);
+
+    o_u.copyFrom(u0.data());
+    o_unew.copyFrom(u0.data());
+    const double tiledTime = runSweeps(device, o_u, o_unew, steps,
+      [&](occa::memory &u, occa::memory &unew) {
+        jacobi2dTiled(N2, N2, u, unew);
+      });
+    passed = passed && checkResult(o_u, uRef);
+    printRate("jacobi2dTiled", points, tiledTime, naiveTime);
+
+    // Each launch advances tsteps sweeps
+    o_u.copyFrom(u0.data());
+    o_unew.copyFrom(u0.data());
+    const double temporalTime = runSweeps(device, o_u, o_unew, steps / tsteps,
+      [&](occa::memory &u, occa::memory &unew) {
+        jacobi2dTemporal(N2, N2, u, unew);
+      });
+    passed = passed && checkResult(o_u, uRef);
+    printRate("jacobi2dTemporal", points, temporalTime, naiveTime);
+  }
+  //======================================
+
+  //---[ 3D ]-----------------------------
+  {
+    std::vector<double> u0(N3 * N3 * N3);
+    for (double &v : u0) v = dist(gen);
+
+    std::vector<double> uRef(u0);
+    jacobi3dReference(N3, steps, uRef);
+
+    const double points = static_cast<double>(N3 - 2) * (N3 - 2) * (N3 - 2) * steps;
+
+    occa::memory o_u    = device.malloc<double>(N3 * N3 * N3, u0.data());
+    occa::memory o_unew = device.malloc<double>(N3 * N3 * N3, u0.data());
+
+    const double naiveTime = runSweeps(device, o_u, o_unew, steps,
+      [&](occa::memory &u, occa::memory &unew) {
+        jacobi3dNaive(N3, N3, N3, u, unew);
+      });
+    passed = passed && checkResult(o_u, uRef);
+    printRate("jacobi3dNaive", points, naiveTime, naiveTime);
+
+    o_u.copyFrom(u0.data());
+    o_unew.copyFrom(u0.data());
+    const double tiledTime = runSweeps(device, o_u, o_unew, steps,
+      [&](occa::memory &u, occa::memory &unew) {
+        jacobi3dTiled(N3, N3, N3, u, unew);
+      });
+    passed = passed && checkResult(o_u, uRef);
+    printRate("jacobi3dTiled", points, tiledTime, naiveTime);
+  }
+  //======================================
+
+  if (!passed) {
+    std::cout << "FAILED" << std::endl;
+    throw 1;
+  }
+  std::cout << "PASSED!" << std::endl;
+  return 0;
+}
@@ -0,0 +1,161 @@
+#include <iostream>
+#include <random>
+
+#include <occa.hpp>
+
+//---[ Internal Tools ]-----------------
+// Note: These headers are not officially supported
+//       Please don't rely on it outside of the occa examples
+#include <occa/internal/utils/cli.hpp>
+#include <occa/internal/utils/testing.hpp>
+//======================================
+
+#include "tracer.hpp"
+
+occa::json parseArgs(int argc, const char **argv) {
+  occa::cli::parser parser;
+  parser
+    .withDescription(
+      "Tracing kernel launches, copies, and streams"
+    )
+    .addOption(
+      occa::cli::option('d', "device",
+                        "Device mode. Can be Serial, OpenMP, OpenCL, CUDA, HIP, or SYCL (default: Serial)")
+      .withArg()
+      .withDefaultValue("Serial")
+    )
+    .addOption(
+      occa::cli::option('n', "entries",
+                        "Vector length")
+      .withArg()
+      .withDefaultValue("100000")
+    )
+    .addOption(
+      occa::cli::option('t', "trace",
+                        "Write a Chrome trace-event JSON timeline to this file. Tracing is off if not given")
+      .withArg()
+      .withDefaultValue("")
+    );
+
+  occa::json args = parser.parseArgs(argc, argv);
+  return args;
+}
+
+int main(int argc, const char **argv) {
+
+  // Parse arguments to json
+  occa::json args = parseArgs(argc, argv);
+
+  std::string mode;
+  if (args["options/device"]=="Serial") {
+    mode = "{mode: 'Serial'}";
+  } else if (args["options/device"]=="OpenMP") {
+    mode = "{mode: 'OpenMP'}";
+  } else if (args["options/device"]=="OpenCL") {
+    mode = "{mode: 'OpenCL', platform_id: 0, device_id: 0}";
+  } else if (args["options/device"]=="CUDA") {
+    mode = "{mode: 'CUDA', device_id: 0}";
+  } else if (args["options/device"]=="HIP") {
+    mode = "{mode: 'HIP', device_id: 0}";
+  } else if (args["options/device"]=="SYCL") {
+    mode = "{mode: 'SYCL', device_id: 0}";
+  }
+  // Create & setup occa::device
+  occa::device device(mode);
+
+  /*
+  The tracer wraps the device. With no trace file requested it is
+  disabled and each traced call goes straight through to OCCA.
+  */
+  const std::string traceFile = args["options/trace"];
+  tracer trace(device, !traceFile.empty());
+
+  // Create some vectors in host memory
+  const int entries = std::stoi(args["options/entries"]);
+  std::vector<float> x(entries);
+  std::vector<float> y(entries);
+
+  std::mt19937 gen(0);
+  std::uniform_real_distribution<float> dist(-1, 1);
+
+  for (int i = 0; i < entries; ++i) {
+    x[i] = dist(gen);
+    y[i] = dist(gen);
+  }
+
+  occa::memory o_x = device.malloc<float>(entries);
+  occa::memory o_y = device.malloc<float>(entries);
+  occa::memory o_z = device.malloc<float>(entries);
+  occa::memory o_p = device.malloc<float>(entries);
+
+  occa::memory h_z = device.malloc<float>(entries, occa::json("host", true));
+  occa::memory h_p = device.malloc<float>(entries, occa::json("host", true));
+
+  trace.copyFrom(o_x, x.data());
+  trace.copyFrom(o_y, y.data());
+
+  occa::kernel addVectors  = trace.buildKernel(
+                                    OCCA_BUILD_DIR "/04_Streams/kernels.okl",
+                                    "addVectors");
+  occa::kernel multVectors = trace.buildKernel(
+                                    OCCA_BUILD_DIR "/04_Streams/kernels.okl",
+                                    "multVectors");
+
+  occa::stream stream1 = device.getStream();
+  occa::stream stream2 = device.createStream();
+
+  // The same interleaving as 04_Streams, with every call traced
+  device.setStream(stream2);
+
+  trace.launch(addVectors, entries, o_x, o_y, o_z);
+
+  trace.copyFrom(h_z, o_z,
+                 /*Nbytes*/entries*sizeof(float),
+                 /*Offset*/0,
+                 /*Async*/ occa::json("async", true));
+
+  device.setStream(stream1);
+
+  trace.launch(multVectors, entries, o_x, o_y, o_p);
+
+  trace.copyFrom(h_p, o_p,
+                 /*Nbytes*/entries*sizeof(float),
+                 /*Offset*/0,
+                 /*Async*/ occa::json("async", true));
+
+  device.setStream(stream2);
+  trace.finish();
+
+  // h_z is now safe to use
+  float* z = static_cast<float*>(h_z.ptr());
+
+  // Check correctness
+  for (int i = 0; i < entries; ++i) {
+    if (!occa::areBitwiseEqual(z[i], x[i] + y[i])) {
+      std::cout << "FAILED" << std::endl;
+      throw 1;
+    }
+  }
+
+  device.setStream(stream1);
+  trace.finish();
+
+  // h_p is now safe to use
+  float* p = static_cast<float*>(h_p.ptr());
+
+  // Check correctness
+  for (int i = 0; i < entries; ++i) {
+    if (!occa::areBitwiseEqual(p[i], x[i] * y[i])) {
+      std::cout << "FAILED" << std::endl;
+      throw 1;
+    }
+  }
+
+  if (trace.isEnabled()) {
+    trace.write(traceFile);
+    std::cout << "Wrote trace to " << traceFile << std::endl;
+  }
+
+  std::cout << "PASSED!" << std::endl;
+  return 0;
+}
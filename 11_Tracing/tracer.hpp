@@ -0,0 +1,253 @@
+#ifndef TRACER_HPP
+#define TRACER_HPP
+
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <occa.hpp>
+
+/*
+An opt-in timeline tracer for kernel launches, copies, kernel builds, and
+finishes. Wrap the calls to trace through a tracer and write the result as
+Chrome trace-event JSON, which can be opened in chrome://tracing or
+ui.perfetto.dev. Each stream is shown as its own row.
+
+When tracing is disabled every wrapper is a single branch in front of the
+wrapped call, so the wrappers can be left in place in production code.
+
+Launches and copies are timed with stream tags, so on async backends the
+timeline shows when the work ran on the device rather than when it was
+queued. Builds and finishes block the host and are timed on the host.
+*/
+class tracer {
+ public:
+  tracer(occa::device device_, const bool enabled_ = false) :
+    device(device_),
+    enabled(enabled_) {
+    if (enabled) {
+      hostOrigin = clock::now();
+      originTag = device.tagStream();
+    }
+  }
+
+  bool isEnabled() const {
+    return enabled;
+  }
+
+  template <class... Args>
+  void launch(occa::kernel &kernel, const Args&... args) {
+    if (!enabled) {
+      kernel(args...);
+      return;
+    }
+    event e = beginDeviceEvent(kernel.name(), "kernel");
+    e.bytes = argBytes(args...);
+    kernel(args...);
+    endDeviceEvent(e);
+  }
+
+  void copyFrom(occa::memory dest,
+                const void *src,
+                const occa::dim_t bytes = -1,
+                const occa::dim_t offset = 0,
+                const occa::json &props = occa::json()) {
+    if (!enabled) {
+      dest.copyFrom(src, bytes, offset, props);
+      return;
+    }
+    event e = beginDeviceEvent("copyFrom host", "copy");
+    e.bytes = (bytes < 0) ? dest.size() - offset : bytes;
+    dest.copyFrom(src, bytes, offset, props);
+    endDeviceEvent(e);
+  }
+
+  void copyFrom(occa::memory dest,
+                const occa::memory src,
+                const occa::dim_t bytes = -1,
+                const occa::dim_t offset = 0,
+                const occa::json &props = occa::json()) {
+    if (!enabled) {
+      dest.copyFrom(src, bytes, offset, props);
+      return;
+    }
+    event e = beginDeviceEvent("copyFrom memory", "copy");
+    e.bytes = (bytes < 0) ? dest.size() - offset : bytes;
+    dest.copyFrom(src, bytes, offset, props);
+    endDeviceEvent(e);
+  }
+
+  void copyTo(const occa::memory src,
+              void *dest,
+              const occa::dim_t bytes = -1,
+              const occa::dim_t offset = 0,
+              const occa::json &props = occa::json()) {
+    if (!enabled) {
+      src.copyTo(dest, bytes, offset, props);
+      return;
+    }
+    event e = beginDeviceEvent("copyTo host", "copy");
+    e.bytes = (bytes < 0) ? src.size() - offset : bytes;
+    src.copyTo(dest, bytes, offset, props);
+    endDeviceEvent(e);
+  }
+
+  occa::kernel buildKernel(const std::string &filename,
+                           const std::string &kernelName,
+                           const occa::json &props = occa::json()) {
+    if (!enabled) {
+      return device.buildKernel(filename, kernelName, props);
+    }
+    event e = beginHostEvent("buildKernel " + kernelName, "build");
+    occa::kernel kernel = device.buildKernel(filename, kernelName, props);
+    endHostEvent(e);
+    return kernel;
+  }
+
+  // Finish the device's current stream
+  void finish() {
+    if (!enabled) {
+      device.finish();
+      return;
+    }
+    event e = beginHostEvent("finish", "sync");
+    device.finish();
+    endHostEvent(e);
+  }
+
+  /*
+  Write the recorded events as Chrome trace-event JSON. Stream tags can
+  only be compared once the work they mark has completed, so this waits
+  for every stream that was traced.
+  */
+  void write(const std::string &filename) {
+    if (!enabled) {
+      return;
+    }
+
+    occa::stream current = device.getStream();
+    for (occa::stream &stream : streams) {
+      device.setStream(stream);
+      device.finish();
+    }
+    device.setStream(current);
+
+    std::ofstream file(filename);
+    file << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+
+    for (size_t s = 0; s < streams.size(); ++s) {
+      file << "  {\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": " << s
+           << ", \"args\": {\"name\": \"stream " << s << "\"}},\n";
+    }
+
+    for (size_t n = 0; n < events.size(); ++n) {
+      const event &e = events[n];
+
+      double begin, duration;
+      if (e.onDevice) {
+        begin    = 1.0E6 * device.timeBetween(originTag, e.startTag);
+        duration = 1.0E6 * device.timeBetween(e.startTag, e.endTag);
+      } else {
+        begin    = e.hostBegin;
+        duration = e.hostEnd - e.hostBegin;
+      }
+
+      file << "  {\"name\": \"" << e.name << "\""
+           << ", \"cat\": \"" << e.category << "\""
+           << ", \"ph\": \"X\", \"pid\": 0, \"tid\": " << e.streamId
+           << ", \"ts\": " << begin
+           << ", \"dur\": " << duration
+           << ", \"args\": {\"bytes\": " << e.bytes << "}}"
+           << ((n + 1 < events.size()) ? ",\n" : "\n");
+    }
+    file << "]}\n";
+  }
+
+ private:
+  typedef std::chrono::steady_clock clock;
+
+  struct event {
+    std::string name;
+    std::string category;
+    int streamId;
+    occa::udim_t bytes = 0;
+
+    bool onDevice;
+    occa::streamTag startTag, endTag;
+    double hostBegin, hostEnd;
+  };
+
+  occa::device device;
+  bool enabled;
+
+  clock::time_point hostOrigin;
+  occa::streamTag originTag;
+
+  std::vector<occa::stream> streams;
+  std::vector<event> events;
+
+  // Microseconds since the tracer was created
+  double hostTime() const {
+    return std::chrono::duration<double, std::micro>(clock::now() - hostOrigin).count();
+  }
+
+  // Small integer ID for the device's current stream, assigned on first use
+  int currentStreamId() {
+    occa::stream stream = device.getStream();
+    for (size_t s = 0; s < streams.size(); ++s) {
+      if (streams[s] == stream) {
+        return static_cast<int>(s);
+      }
+    }
+    streams.push_back(stream);
+    return static_cast<int>(streams.size() - 1);
+  }
+
+  event beginDeviceEvent(const std::string &name, const std::string &category) {
+    event e;
+    e.name = name;
+    e.category = category;
+    e.streamId = currentStreamId();
+    e.onDevice = true;
+    e.startTag = device.tagStream();
+    return e;
+  }
+
+  void endDeviceEvent(event &e) {
+    e.endTag = device.tagStream();
+    events.push_back(e);
+  }
+
+  event beginHostEvent(const std::string &name, const std::string &category) {
+    event e;
+    e.name = name;
+    e.category = category;
+    e.streamId = currentStreamId();
+    e.onDevice = false;
+    e.hostBegin = hostTime();
+    return e;
+  }
+
+  void endHostEvent(event &e) {
+    e.hostEnd = hostTime();
+    events.push_back(e);
+  }
+
+  // Kernel launches report the total size of their occa::memory arguments
+  static occa::udim_t argBytes() {
+    return 0;
+  }
+
+  template <class... Args>
+  static occa::udim_t argBytes(const occa::memory &arg, const Args&... args) {
+    return arg.size() + argBytes(args...);
+  }
+
+  template <class T, class... Args>
+  static occa::udim_t argBytes(const T &arg, const Args&... args) {
+    return argBytes(args...);
+  }
+};
+
+#endif
@@ -0,0 +1,228 @@
+#include <iostream>
+#include <random>
+#include <cmath>
+
+#include <occa.hpp>
+
+//---[ Internal Tools ]-----------------
+// Note: These headers are not officially supported
+//       Please don't rely on it outside of the occa examples
+#include <occa/internal/utils/cli.hpp>
+#include <occa/internal/utils/testing.hpp>
+//======================================
+
+#include "roofline.hpp"
+
+occa::json parseArgs(int argc, const char **argv) {
+  occa::cli::parser parser;
+  parser
+    .withDescription(
+      "Roofline analysis of the tutorial kernels"
+    )
+    .addOption(
+      occa::cli::option('d', "device",
+                        "Device mode. Can be Serial, OpenMP, OpenCL, CUDA, HIP, or SYCL (default: Serial)")
+      .withArg()
+      .withDefaultValue("Serial")
+    )
+    .addOption(
+      occa::cli::option('n', "entries",
+                        "Vector length for addVectors and sum")
+      .withArg()
+      .withDefaultValue("10000000")
+    )
+    .addOption(
+      occa::cli::option('m', "dim",
+                        "Square matrix dimension for matrixMultiply")
+      .withArg()
+      .withDefaultValue("512")
+    )
+    .addOption(
+      occa::cli::option('t', "triad-entries",
+                        "Vector length for the STREAM triad probe. Should be well beyond the last level cache")
+      .withArg()
+      .withDefaultValue("16777216")
+    )
+    .addOption(
+      occa::cli::option('i', "iterations",
+                        "Timed iterations per kernel")
+      .withArg()
+      .withDefaultValue("10")
+    );
+
+  occa::json args = parser.parseArgs(argc, argv);
+  return args;
+}
+
+int main(int argc, const char **argv) {
+
+  // Parse arguments to json
+  occa::json args = parseArgs(argc, argv);
+
+  std::string mode;
+  if (args["options/device"]=="Serial") {
+    mode = "{mode: 'Serial'}";
+  } else if (args["options/device"]=="OpenMP") {
+    mode = "{mode: 'OpenMP'}";
+  } else if (args["options/device"]=="OpenCL") {
+    mode = "{mode: 'OpenCL', platform_id: 0, device_id: 0}";
+  } else if (args["options/device"]=="CUDA") {
+    mode = "{mode: 'CUDA', device_id: 0}";
+  } else if (args["options/device"]=="HIP") {
+    mode = "{mode: 'HIP', device_id: 0}";
+  } else if (args["options/device"]=="SYCL") {
+    mode = "{mode: 'SYCL', device_id: 0}";
+  }
+  // Create & setup occa::device
+  occa::device device(mode);
+
+  const int entries = std::stoi(args["options/entries"]);
+  const int dim = std::stoi(args["options/dim"]);
+  const int iterations = std::stoi(args["options/iterations"]);
+
+  roofline model(device);
+  model.measurePeaks(std::stoi(args["options/triad-entries"]), iterations);
+  model.printPeaks();
+
+  std::mt19937 gen(0);
+  std::uniform_real_distribution<float> dist(-1, 1);
+
+  //---[ addVectors ]---------------------
+  std::vector<float> a(entries), b(entries);
+  for (int i = 0; i < entries; ++i) {
+    a[i] = dist(gen);
+    b[i] = dist(gen);
+  }
+  occa::memory o_a  = device.malloc<float>(entries, a.data());
+  occa::memory o_b  = device.malloc<float>(entries, b.data());
+  occa::memory o_ab = device.malloc<float>(entries);
+
+  occa::kernel addVectors = device.buildKernel(
+                                    OCCA_BUILD_DIR "/01_Introduction/addVectors.okl",
+                                    "addVectors");
+
+  // Two loads, one store, and one add per entry
+  model.registerKernel("addVectors",
+                       /*bytes*/ 3.0 * sizeof(float) * entries,
+                       /*flops*/ 1.0 * entries,
+                       roofline::singlePrecision);
+  //======================================
+
+  //---[ matrixMultiply ]-----------------
+  const int M = dim, N = dim, K = dim;
+  std::vector<float> A(K * M), B(N * K);
+  for (float &v : A) v = dist(gen);
+  for (float &v : B) v = dist(gen);
+
+  occa::memory o_A = device.malloc<float>(K * M, A.data());
+  occa::memory o_B = device.malloc<float>(N * K, B.data());
+  occa::memory o_C = device.malloc<float>(N * M);
+
+  occa::json gemmProperties;
+  gemmProperties["defines"].asObject();
+  gemmProperties["defines/N_TILE_SIZE"] = 16;
+  gemmProperties["defines/M_TILE_SIZE"] = 16;
+
+  occa::kernel matrixMultiply = device.buildKernel(
+                                    OCCA_BUILD_DIR "/02_Loops/matrixMultiply.okl",
+                                    "matrixMultiply",
+                                    gemmProperties);
+
+  /*
+  A multiply-add per (m, n, k). Bytes count only the compulsory traffic
+  of reading A and B and writing C once, so a low percentage here means
+  the kernel re-reads A and B from memory instead of reusing them.
+  */
+  model.registerKernel("matrixMultiply",
+                       /*bytes*/ sizeof(float) * (1.0 * M * K + 1.0 * K * N + 1.0 * M * N),
+                       /*flops*/ 2.0 * M * N * K,
+                       roofline::singlePrecision);
+  //======================================
+
+  //---[ sum ]----------------------------
+  const int maxBlocks = 512;
+  std::vector<double> x(entries);
+  for (double &v : x) v = dist(gen);
+
+  occa::memory o_x = device.malloc<double>(entries, x.data());
+  occa::memory o_scratch = device.malloc<double>(maxBlocks);
+  occa::memory o_sum = device.malloc<double>(1);
+
+  occa::json sumProperties;
+  sumProperties["defines"].asObject();
+  sumProperties["defines/MAX_BLOCKS"] = maxBlocks;
+  sumProperties["defines/BLOCK_SIZE"] = 256;
+
+  occa::kernel sumKernel = device.buildKernel(
+                                    OCCA_BUILD_DIR "/03_Reduction/sum.okl",
+                                    "sum",
+                                    sumProperties);
+
+  // One load and one add per entry
+  model.registerKernel("sum",
+                       /*bytes*/ 1.0 * sizeof(double) * entries,
+                       /*flops*/ 1.0 * entries,
+                       roofline::doublePrecision);
+  //======================================
+
+  const int Nblocks = (entries < maxBlocks) ? entries : maxBlocks;
+
+  std::cout << std::endl;
+  model.printHeader();
+  model.report("addVectors", model.time(iterations, [&]() {
+    addVectors(entries, o_a, o_b, o_ab);
+  }));
+  model.report("matrixMultiply", model.time(iterations, [&]() {
+    matrixMultiply(N, M, K,
+                   o_A, M,
+                   o_B, K,
+                   o_C, M);
+  }));
+  model.report("sum", model.time(iterations, [&]() {
+    sumKernel(entries, Nblocks, o_x, o_scratch, o_sum);
+  }));
+
+  /*
+  A kernel that skips work can look fast against the roofline, so check
+  the results of the timed runs against host references
+  */
+  bool passed = true;
+
+  std::vector<float> ab(entries);
+  o_ab.copyTo(ab.data());
+  for (int i = 0; i < entries; ++i) {
+    if (ab[i] != a[i] + b[i]) {
+      passed = false;
+      break;
+    }
+  }
+
+  // The first column of C is enough to catch a kernel that skips products
+  std::vector<float> C(M);
+  o_C.copyTo(C.data(), M * sizeof(float));
+  for (int m = 0; m < M; ++m) {
+    float c = 0.0f;
+    for (int k = 0; k < K; ++k) {
+      c += A[m + k * M] * B[k];
+    }
+    if (std::abs(C[m] - c) > 1.0E-5 * K) {
+      passed = false;
+      break;
+    }
+  }
+
+  double sum, ref = 0.0, tolerance = 0.0;
+  o_sum.copyTo(&sum);
+  for (int i = 0; i < entries; ++i) {
+    ref += x[i];
+    tolerance += std::abs(x[i]);
+  }
+  passed = passed && (std::abs(sum - ref) <= 1.0E-12 * tolerance);
+
+  if (!passed) {
+    std::cout << "FAILED" << std::endl;
+    throw 1;
+  }
+  std::cout << "PASSED!" << std::endl;
+  return 0;
+}
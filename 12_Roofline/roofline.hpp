@@ -0,0 +1,164 @@
+#ifndef ROOFLINE_HPP
+#define ROOFLINE_HPP
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <occa.hpp>
+
+/*
+Roofline model of a device. The ceilings are measured with the probes in
+roofline.okl, and each kernel is registered with an analytic count of
+the bytes it must move and the flops it must perform. A timed run of a
+kernel can then be placed against the ceilings:
+
+  arithmetic intensity = flops / bytes
+  attainable GFLOP/s   = min(peak GFLOP/s, intensity * peak GB/s)
+*/
+class roofline {
+ public:
+  enum precision {
+    singlePrecision,
+    doublePrecision
+  };
+
+  roofline(occa::device device_) :
+    device(device_) {}
+
+  // Measure the memory bandwidth and the single and double precision flop rates
+  void measurePeaks(const int triadEntries, const int iterations) {
+    occa::json properties;
+    properties["defines"].asObject();
+    properties["defines/BLOCK_SIZE"] = 256;
+    properties["defines/REAL"] = "double";
+
+    occa::kernel streamTriad = device.buildKernel(
+                                    OCCA_BUILD_DIR "/12_Roofline/roofline.okl",
+                                    "streamTriad",
+                                    properties);
+    occa::kernel peakFlopsDouble = device.buildKernel(
+                                    OCCA_BUILD_DIR "/12_Roofline/roofline.okl",
+                                    "peakFlops",
+                                    properties);
+
+    properties["defines/REAL"] = "float";
+    occa::kernel peakFlopsSingle = device.buildKernel(
+                                    OCCA_BUILD_DIR "/12_Roofline/roofline.okl",
+                                    "peakFlops",
+                                    properties);
+
+    /*
+    The inputs must hold ordinary values: uninitialized pages can contain
+    denormals or NaNs, which are slow on some CPUs and would understate the
+    bandwidth ceiling
+    */
+    const std::vector<double> ones(triadEntries, 1.0);
+    occa::memory o_a = device.malloc<double>(triadEntries);
+    occa::memory o_b = device.malloc<double>(triadEntries, ones.data());
+    occa::memory o_c = device.malloc<double>(triadEntries, ones.data());
+
+    const double triadTime = time(iterations, [&]() {
+      streamTriad(triadEntries, 3.0, o_a, o_b, o_c);
+    });
+    bandwidth = 3.0 * sizeof(double) * triadEntries / triadTime;
+
+    // Eight chains of one multiply-add (two flops) per iteration
+    const int flopEntries = 1 << 18;
+    const int flopIterations = 256;
+    const double flops = 16.0 * flopEntries * flopIterations;
+
+    occa::memory o_out = device.malloc<double>(flopEntries);
+
+    const double doubleTime = time(iterations, [&]() {
+      peakFlopsDouble(flopEntries, flopIterations, 0.999, 0.001, o_out);
+    });
+    peakDouble = flops / doubleTime;
+
+    const double singleTime = time(iterations, [&]() {
+      peakFlopsSingle(flopEntries, flopIterations, 0.999f, 0.001f, o_out);
+    });
+    peakSingle = flops / singleTime;
+  }
+
+  void registerKernel(const std::string &name,
+                      const double bytes,
+                      const double flops,
+                      const precision prec) {
+    models[name] = model{bytes, flops, prec};
+  }
+
+  void printPeaks() const {
+    std::cout << "Measured ceilings" << std::endl
+              << "  Memory bandwidth: " << bandwidth  / 1.0E9 << " GB/s" << std::endl
+              << "  Single precision: " << peakSingle / 1.0E9 << " GFLOP/s" << std::endl
+              << "  Double precision: " << peakDouble / 1.0E9 << " GFLOP/s" << std::endl;
+  }
+
+  void printHeader() const {
+    std::cout << std::left << std::setw(16) << "kernel"
+              << std::right << std::setw(12) << "time [ms]"
+              << std::setw(12) << "flop/byte"
+              << std::setw(10) << "GB/s"
+              << std::setw(11) << "GFLOP/s"
+              << std::setw(13) << "attainable"
+              << std::setw(11) << "% roof"
+              << std::setw(9) << "bound" << std::endl;
+  }
+
+  // Place a timed run of a registered kernel against the roofline
+  void report(const std::string &name, const double seconds) const {
+    const model &m = models.at(name);
+
+    const double peakFlops = (m.prec == doublePrecision) ? peakDouble : peakSingle;
+    const double intensity = m.flops / m.bytes;
+    const double attainable = std::min(peakFlops, intensity * bandwidth);
+    const double achieved = m.flops / seconds;
+
+    std::cout << std::left << std::setw(16) << name
+              << std::right << std::fixed
+              << std::setw(12) << std::setprecision(3) << seconds * 1.0E3
+              << std::setw(12) << intensity
+              << std::setw(10) << std::setprecision(1) << m.bytes / seconds / 1.0E9
+              << std::setw(11) << achieved / 1.0E9
+              << std::setw(13) << attainable / 1.0E9
+              << std::setw(10) << 100.0 * achieved / attainable << "%"
+              << std::setw(9) << ((intensity * bandwidth < peakFlops) ? "memory" : "compute")
+              << std::endl;
+  }
+
+  // Average time of a launch, measured between stream tags
+  template <class Launch>
+  double time(const int iterations, Launch launch) {
+    // Warm up
+    launch();
+
+    occa::streamTag start = device.tagStream();
+    for (int it = 0; it < iterations; ++it) {
+      launch();
+    }
+    occa::streamTag end = device.tagStream();
+    device.waitFor(end);
+    return device.timeBetween(start, end) / iterations;
+  }
+
+ private:
+  struct model {
+    double bytes;
+    double flops;
+    precision prec;
+  };
+
+  occa::device device;
+
+  double bandwidth = 0.0;
+  double peakSingle = 0.0;
+  double peakDouble = 0.0;
+
+  std::map<std::string, model> models;
+};
+
+#endif
@@ -0,0 +1,132 @@
+#ifndef LAUNCH_GRAPH_HPP
+#define LAUNCH_GRAPH_HPP
+
+#include <algorithm>
+#include <vector>
+
+#include <occa.hpp>
+
+/*
+A fixed sequence of kernel launches and copies, captured once with their
+bound arguments and replayed many times.
+
+Calling an occa::kernel as a functor builds a fresh argument list from
+the call's arguments and pushes it to the kernel on every launch. A
+launchGraph converts each argument to an occa::kernelArg once, at capture.
+On replay, a kernel whose arguments are still bound from its last replay
+is just run; its arguments are only pushed again if they were updated
+with setArg() or if another node of the graph launched the same kernel
+in between.
+
+Launching a captured kernel directly, outside the graph, replaces its
+bound arguments. Call invalidate() before the next replay if that happens.
+*/
+class launchGraph {
+ public:
+  // Capture a kernel launch. Returns the node index, for use with setArg()
+  template <class... Args>
+  int addKernel(occa::kernel kernel, const Args&... args) {
+    node n;
+    n.isCopy = false;
+    n.kernel = kernel;
+    n.args = {occa::kernelArg(args)...};
+
+    // Nodes launching the same kernel share its argument slots
+    n.kernelId = static_cast<int>(kernels.size());
+    for (size_t k = 0; k < kernels.size(); ++k) {
+      if (kernels[k] == kernel) {
+        n.kernelId = static_cast<int>(k);
+        break;
+      }
+    }
+    if (n.kernelId == static_cast<int>(kernels.size())) {
+      kernels.push_back(kernel);
+      boundNode.push_back(-1);
+    }
+
+    nodes.push_back(n);
+    return static_cast<int>(nodes.size() - 1);
+  }
+
+  // Capture a copy between two occa::memory buffers
+  int addCopy(occa::memory dest,
+              occa::memory src,
+              const occa::dim_t bytes = -1,
+              const occa::dim_t destOffset = 0,
+              const occa::dim_t srcOffset = 0,
+              const occa::json &props = occa::json()) {
+    node n;
+    n.isCopy = true;
+    n.dest = dest;
+    n.src = src;
+    n.bytes = bytes;
+    n.destOffset = destOffset;
+    n.srcOffset = srcOffset;
+    n.props = props;
+
+    nodes.push_back(n);
+    return static_cast<int>(nodes.size() - 1);
+  }
+
+  // Update one argument of a captured launch in place, e.g. a changed scalar
+  template <class T>
+  void setArg(const int nodeIndex, const int argIndex, const T &value) {
+    node &n = nodes[nodeIndex];
+    n.args[argIndex] = occa::kernelArg(value);
+    if (boundNode[n.kernelId] == nodeIndex) {
+      boundNode[n.kernelId] = -1;
+    }
+  }
+
+  // Queue every captured launch and copy, in capture order
+  void replay() {
+    for (size_t i = 0; i < nodes.size(); ++i) {
+      node &n = nodes[i];
+      if (n.isCopy) {
+        n.dest.copyFrom(n.src, n.bytes, n.destOffset, n.srcOffset, n.props);
+        continue;
+      }
+
+      if (boundNode[n.kernelId] != static_cast<int>(i)) {
+        n.kernel.clearArgs();
+        for (const occa::kernelArg &arg : n.args) {
+          n.kernel.pushArg(arg);
+        }
+        boundNode[n.kernelId] = static_cast<int>(i);
+      }
+      n.kernel.run();
+    }
+  }
+
+  // Force every launch to push its arguments again on the next replay
+  void invalidate() {
+    std::fill(boundNode.begin(), boundNode.end(), -1);
+  }
+
+  int size() const {
+    return static_cast<int>(nodes.size());
+  }
+
+ private:
+  struct node {
+    bool isCopy;
+
+    // Kernel launch
+    occa::kernel kernel;
+    int kernelId;
+    std::vector<occa::kernelArg> args;
+
+    // Copy
+    occa::memory dest, src;
+    occa::dim_t bytes, destOffset, srcOffset;
+    occa::json props;
+  };
+
+  std::vector<node> nodes;
+
+  // Distinct kernels in the graph, and which node's arguments each currently holds
+  std::vector<occa::kernel> kernels;
+  std::vector<int> boundNode;
+};
+
+#endif
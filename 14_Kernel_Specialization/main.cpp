@@ -0,0 +1,246 @@
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <sstream>
+
+#include <occa.hpp>
+
+//---[ Internal Tools ]-----------------
+// Note: These headers are not officially supported
+//       Please don't rely on it outside of the occa examples
+#include <occa/internal/utils/cli.hpp>
+#include <occa/internal/utils/testing.hpp>
+//======================================
+
+#include "specializedKernel.hpp"
+
+occa::json parseArgs(int argc, const char **argv) {
+  occa::cli::parser parser;
+  parser
+    .withDescription(
+      "Compile-time size specialization of kernels"
+    )
+    .addOption(
+      occa::cli::option('d', "device",
+                        "Device mode. Can be Serial, OpenMP, OpenCL, CUDA, HIP, or SYCL (default: Serial)")
+      .withArg()
+      .withDefaultValue("Serial")
+    )
+    .addOption(
+      occa::cli::option('m', "matrix-sizes",
+                        "Comma separated square matrix sizes to benchmark")
+      .withArg()
+      .withDefaultValue("64,128,256")
+    )
+    .addOption(
+      occa::cli::option('n', "vector-sizes",
+                        "Comma separated vector lengths to benchmark")
+      .withArg()
+      .withDefaultValue("4096,65536,1048576")
+    )
+    .addOption(
+      occa::cli::option('c', "capacity",
+                        "Maximum specialized variants cached per kernel")
+      .withArg()
+      .withDefaultValue("4")
+    )
+    .addOption(
+      occa::cli::option('i', "iterations",
+                        "Timed iterations per kernel")
+      .withArg()
+      .withDefaultValue("20")
+    );
+
+  occa::json args = parser.parseArgs(argc, argv);
+  return args;
+}
+
+std::vector<int> parseSizes(const std::string &list) {
+  std::vector<int> sizes;
+  std::stringstream ss(list);
+  std::string size;
+  while (std::getline(ss, size, ',')) {
+    sizes.push_back(std::stoi(size));
+  }
+  return sizes;
+}
+
+template <class Launch>
+double timeKernel(occa::device &device, const int iterations, Launch launch) {
+  // Warm up
+  launch();
+
+  occa::streamTag start = device.tagStream();
+  for (int it = 0; it < iterations; ++it) {
+    launch();
+  }
+  occa::streamTag end = device.tagStream();
+  device.waitFor(end);
+  return device.timeBetween(start, end) / iterations;
+}
+
+void printTimes(const std::string &name, const int size,
+                const double genericTime, const double specializedTime) {
+  std::cout << std::left << std::setw(16) << name
+            << std::right << std::setw(10) << size
+            << std::setw(14) << std::fixed << std::setprecision(3) << genericTime * 1.0E3
+            << std::setw(16) << specializedTime * 1.0E3
+            << std::setw(10) << std::setprecision(2) << genericTime / specializedTime << std::endl;
+}
+
+int main(int argc, const char **argv) {
+
+  // Parse arguments to json
+  occa::json args = parseArgs(argc, argv);
+
+  std::string mode;
+  if (args["options/device"]=="Serial") {
+    mode = "{mode: 'Serial'}";
+  } else if (args["options/device"]=="OpenMP") {
+    mode = "{mode: 'OpenMP'}";
+  } else if (args["options/device"]=="OpenCL") {
+    mode = "{mode: 'OpenCL', platform_id: 0, device_id: 0}";
+  } else if (args["options/device"]=="CUDA") {
+    mode = "{mode: 'CUDA', device_id: 0}";
+  } else if (args["options/device"]=="HIP") {
+    mode = "{mode: 'HIP', device_id: 0}";
+  } else if (args["options/device"]=="SYCL") {
+    mode = "{mode: 'SYCL', device_id: 0}";
+  }
+  // Create & setup occa::device
+  occa::device device(mode);
+
+  const std::vector<int> matrixSizes = parseSizes(args["options/matrix-sizes"]);
+  const std::vector<int> vectorSizes = parseSizes(args["options/vector-sizes"]);
+  const size_t capacity = std::stoi(args["options/capacity"]);
+  const int iterations = std::stoi(args["options/iterations"]);
+
+  const int maxBlocks = 512;
+
+  occa::json gemmProperties;
+  gemmProperties["defines"].asObject();
+  gemmProperties["defines/N_TILE_SIZE"] = 16;
+  gemmProperties["defines/M_TILE_SIZE"] = 16;
+
+  occa::json sumProperties;
+  sumProperties["defines"].asObject();
+  sumProperties["defines/MAX_BLOCKS"] = maxBlocks;
+  sumProperties["defines/BLOCK_SIZE"] = 256;
+
+  // Specialize every size argument of each kernel, given by name and argument position
+  specializedKernel matrixMultiply(device,
+                                   OCCA_BUILD_DIR "/14_Kernel_Specialization/matrixMultiply.okl",
+                                   "matrixMultiply",
+                                   gemmProperties,
+                                   {{"N", 0}, {"M", 1}, {"K", 2}},
+                                   capacity);
+  specializedKernel sumKernel(device,
+                              OCCA_BUILD_DIR "/14_Kernel_Specialization/sum.okl",
+                              "sum",
+                              sumProperties,
+                              {{"N", 0}, {"NBLOCKS", 1}},
+                              capacity);
+
+  std::mt19937 gen(0);
+  std::uniform_real_distribution<float> dist(-1, 1);
+
+  bool passed = true;
+
+  std::cout << std::left << std::setw(16) << "kernel"
+            << std::right << std::setw(10) << "size"
+            << std::setw(14) << "generic [ms]"
+            << std::setw(16) << "specialized [ms]"
+            << std::setw(10) << "speedup" << std::endl;
+
+  for (const int n : matrixSizes) {
+    std::vector<float> A(n * n), B(n * n);
+    for (float &v : A) v = dist(gen);
+    for (float &v : B) v = dist(gen);
+
+    occa::memory o_A = device.malloc<float>(n * n, A.data());
+    occa::memory o_B = device.malloc<float>(n * n, B.data());
+    occa::memory o_C = device.malloc<float>(n * n);
+
+    // These are the production sizes, so build their variants up front
+    matrixMultiply.prebuild({n, n, n});
+
+    std::vector<float> Cgeneric(n * n), Cspecialized(n * n);
+
+    const double genericTime = timeKernel(device, iterations, [&]() {
+      matrixMultiply.genericKernel()(n, n, n, o_A, n, o_B, n, o_C, n);
+    });
+    o_C.copyTo(Cgeneric.data());
+
+    const double specializedTime = timeKernel(device, iterations, [&]() {
+      matrixMultiply(n, n, n, o_A, n, o_B, n, o_C, n);
+    });
+    o_C.copyTo(Cspecialized.data());
+
+    for (int i = 0; i < n * n; ++i) {
+      if (std::abs(Cgeneric[i] - Cspecialized[i]) > 1.0E-5 * n) {
+        passed = false;
+      }
+    }
+    printTimes("matrixMultiply", n, genericTime, specializedTime);
+  }
+
+  for (const int n : vectorSizes) {
+    std::vector<double> x(n);
+    for (double &v : x) v = dist(gen);
+
+    occa::memory o_x = device.malloc<double>(n, x.data());
+    occa::memory o_scratch = device.malloc<double>(maxBlocks);
+    occa::memory o_sum = device.malloc<double>(1);
+
+    const int Nblocks = (n < maxBlocks) ? n : maxBlocks;
+    sumKernel.prebuild({n, Nblocks});
+
+    double sumGeneric, sumSpecialized;
+
+    const double genericTime = timeKernel(device, iterations, [&]() {
+      sumKernel.genericKernel()(n, Nblocks, o_x, o_scratch, o_sum);
+    });
+    o_sum.copyTo(&sumGeneric);
+
+    const double specializedTime = timeKernel(device, iterations, [&]() {
+      sumKernel(n, Nblocks, o_x, o_scratch, o_sum);
+    });
+    o_sum.copyTo(&sumSpecialized);
+
+    if (std::abs(sumGeneric - sumSpecialized) > 1.0E-8) {
+      passed = false;
+    }
+    printTimes("sum", n, genericTime, specializedTime);
+  }
+
+  /*
+  A size the cache has never seen runs with the generic kernel and does
+  not trigger a build. Seen again, it gets its own variant, evicting the
+  least recently used one once the cache is full.
+  */
+  const int oddSize = 1000;
+  std::vector<double> x(oddSize, 1.0);
+  occa::memory o_x = device.malloc<double>(oddSize, x.data());
+  occa::memory o_scratch = device.malloc<double>(maxBlocks);
+  occa::memory o_sum = device.malloc<double>(1);
+
+  for (int it = 0; it < 2; ++it) {
+    sumKernel(oddSize, maxBlocks, o_x, o_scratch, o_sum);
+    double sum;
+    o_sum.copyTo(&sum);
+    if (sum != oddSize) {
+      passed = false;
+    }
+  }
+
+  std::cout << std::endl;
+  matrixMultiply.printStatistics(std::cout);
+  sumKernel.printStatistics(std::cout);
+
+  if (!passed) {
+    std::cout << "FAILED" << std::endl;
+    throw 1;
+  }
+  std::cout << "PASSED!" << std::endl;
+  return 0;
+}
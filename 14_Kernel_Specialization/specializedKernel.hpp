@@ -0,0 +1,201 @@
+#ifndef SPECIALIZED_KERNEL_HPP
+#define SPECIALIZED_KERNEL_HPP
+
+#include <algorithm>
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <occa.hpp>
+
+/*
+A kernel with size-specialized variants. Chosen integer arguments are
+baked into the build as SPECIALIZED_<name> defines, and the kernel
+source falls back to the runtime argument when a define is missing.
+
+Variants live in an in-process LRU cache keyed on the specialized values,
+which are read from the launch arguments themselves so a variant can
+never run with sizes other than the ones it was built for. A size seen
+for the first time is launched with the generic kernel, so a one-off
+size never pays for a JIT build; from its second launch on it gets its
+own variant. The sizes seen only once are kept in a second LRU of the
+same capacity. Sizes known ahead of time can be built up front with
+prebuild().
+*/
+class specializedKernel {
+ public:
+  specializedKernel(occa::device device_,
+                    const std::string &filename_,
+                    const std::string &kernelName_,
+                    const occa::json &props_,
+                    const std::vector<std::pair<std::string, int>> &specializedArgs_,
+                    const size_t capacity_) :
+    device(device_),
+    filename(filename_),
+    kernelName(kernelName_),
+    props(props_),
+    specializedArgs(specializedArgs_),
+    capacity(capacity_) {
+    generic = device.buildKernel(filename, kernelName, props);
+  }
+
+  /*
+  Launch with the given kernel arguments. The specialized arguments are
+  picked out of them by position to select the variant.
+  */
+  template <class... Args>
+  void operator () (const Args&... args) {
+    key values(specializedArgs.size());
+    std::vector<bool> found(specializedArgs.size(), false);
+    int position = 0;
+    int expand[] = {0, (collect(position++, args, values, found), 0)...};
+    (void) expand;
+
+    // A specialized position that is not an integer argument cannot be baked in
+    if (std::find(found.begin(), found.end(), false) != found.end()) {
+      ++fallbacks;
+      generic(args...);
+      return;
+    }
+    variant(values)(args...);
+  }
+
+  /*
+  Build the variant for a known size now, instead of on its second use.
+  Values are given in the order of the specialized arguments.
+  */
+  void prebuild(const std::vector<int> &values) {
+    if (cache.find(values) == cache.end()) {
+      forget(values);
+      insert(values);
+    }
+  }
+
+  occa::kernel& genericKernel() {
+    return generic;
+  }
+
+  size_t size() const {
+    return cache.size();
+  }
+
+  void printStatistics(std::ostream &out) const {
+    out << kernelName << " variants: "
+        << cache.size() << "/" << capacity << " cached, "
+        << hits << " hits, "
+        << misses << " builds, "
+        << fallbacks << " generic fallbacks, "
+        << evictions << " evictions, "
+        << seenLru.size() << " sizes seen once" << std::endl;
+  }
+
+ private:
+  typedef std::vector<int> key;
+
+  struct entry {
+    occa::kernel kernel;
+    std::list<key>::iterator lruEntry;
+  };
+
+  occa::device device;
+  std::string filename;
+  std::string kernelName;
+  occa::json props;
+  // Define name and argument position of each specialized argument
+  std::vector<std::pair<std::string, int>> specializedArgs;
+  size_t capacity;
+
+  occa::kernel generic;
+
+  // Most recently used first
+  std::list<key> lru;
+  std::map<key, entry> cache;
+
+  // Sizes launched once with the generic kernel, most recent first
+  std::list<key> seenLru;
+  std::map<key, std::list<key>::iterator> seen;
+
+  size_t hits = 0;
+  size_t misses = 0;
+  size_t fallbacks = 0;
+  size_t evictions = 0;
+
+  void collect(const int position, const int arg, key &values, std::vector<bool> &found) {
+    for (size_t i = 0; i < specializedArgs.size(); ++i) {
+      if (specializedArgs[i].second == position) {
+        values[i] = arg;
+        found[i] = true;
+      }
+    }
+  }
+
+  // Buffers and other non-integer arguments are never specialized
+  template <class T>
+  void collect(const int, const T &, key &, std::vector<bool> &) {}
+
+  occa::kernel variant(const key &values) {
+    auto it = cache.find(values);
+    if (it != cache.end()) {
+      ++hits;
+      // Mark as most recently used
+      lru.splice(lru.begin(), lru, it->second.lruEntry);
+      return it->second.kernel;
+    }
+
+    // Second launch of this size: build its variant
+    if (forget(values)) {
+      ++misses;
+      return insert(values);
+    }
+
+    // First launch: remember the size, dropping the oldest once full
+    if (capacity > 0) {
+      if (seen.size() >= capacity) {
+        seen.erase(seenLru.back());
+        seenLru.pop_back();
+      }
+      seenLru.push_front(values);
+      seen[values] = seenLru.begin();
+    }
+    ++fallbacks;
+    return generic;
+  }
+
+  // Drop a size from the seen-once list, returning whether it was there
+  bool forget(const key &values) {
+    auto it = seen.find(values);
+    if (it == seen.end()) {
+      return false;
+    }
+    seenLru.erase(it->second);
+    seen.erase(it);
+    return true;
+  }
+
+  occa::kernel insert(const key &values) {
+    if (capacity == 0) {
+      return generic;
+    }
+
+    // Evict the least recently used variant. OCCA frees it once no launch holds it
+    if (cache.size() >= capacity) {
+      cache.erase(lru.back());
+      lru.pop_back();
+      ++evictions;
+    }
+
+    occa::json variantProps = props;
+    for (size_t i = 0; i < specializedArgs.size(); ++i) {
+      variantProps["defines/SPECIALIZED_" + specializedArgs[i].first] = values[i];
+    }
+
+    lru.push_front(values);
+    entry &e = cache[values];
+    e.kernel = device.buildKernel(filename, kernelName, variantProps);
+    e.lruEntry = lru.begin();
+    return e.kernel;
+  }
+};
+
+#endif
@@ -0,0 +1,338 @@
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <cmath>
+#include <limits>
+
+#include <occa.hpp>
+
+//---[ Internal Tools ]-----------------
+// Note: These headers are not officially supported
+//       Please don't rely on it outside of the occa examples
+#include <occa/internal/utils/cli.hpp>
+#include <occa/internal/utils/testing.hpp>
+//======================================
+
+occa::json parseArgs(int argc, const char **argv) {
+  occa::cli::parser parser;
+  parser
+    .withDescription(
+      "Fused map-reduce kernels"
+    )
+    .addOption(
+      occa::cli::option('d', "device",
+                        "Device mode. Can be Serial, OpenMP, OpenCL, CUDA, HIP, or SYCL (default: Serial)")
+      .withArg()
+      .withDefaultValue("Serial")
+    )
+    .addOption(
+      occa::cli::option('n', "entries",
+                        "Vector length")
+      .withArg()
+      .withDefaultValue("10000000")
+    )
+    .addOption(
+      occa::cli::option('i', "iterations",
+                        "Timed iterations per kernel")
+      .withArg()
+      .withDefaultValue("10")
+    );
+
+  occa::json args = parser.parseArgs(argc, argv);
+  return args;
+}
+
+// Must match the OPERATION values in mapReduce.okl
+enum operation {
+  DOT          = 0,
+  NORM2        = 1,
+  AXPY_NORM2   = 2,
+  WEIGHTED_SUM = 3
+};
+
+struct fusedCase {
+  std::string name;
+  operation op;
+  bool writeMapped;
+  int inputs;
+};
+
+template <class Launch>
+double timeKernel(occa::device &device, const int iterations, Launch launch) {
+  // Warm up
+  launch();
+
+  occa::streamTag start = device.tagStream();
+  for (int it = 0; it < iterations; ++it) {
+    launch();
+  }
+  occa::streamTag end = device.tagStream();
+  device.waitFor(end);
+  return device.timeBetween(start, end) / iterations;
+}
+
+void printCase(const std::string &name,
+               const double unfusedBytes, const double fusedBytes,
+               const double unfusedTime, const double fusedTime) {
+  std::cout << std::left << std::setw(22) << name
+            << std::right << std::fixed << std::setprecision(1)
+            << std::setw(10) << unfusedBytes / 1.0E6
+            << std::setw(10) << fusedBytes / 1.0E6
+            << std::setw(9) << 100.0 * (1.0 - fusedBytes / unfusedBytes) << "%"
+            << std::setw(12) << std::setprecision(3) << unfusedTime * 1.0E3
+            << std::setw(12) << fusedTime * 1.0E3
+            << std::setw(9) << std::setprecision(2) << unfusedTime / fusedTime << std::endl;
+}
+
+int main(int argc, const char **argv) {
+
+  // Parse arguments to json
+  occa::json args = parseArgs(argc, argv);
+
+  std::string mode;
+  if (args["options/device"]=="Serial") {
+    mode = "{mode: 'Serial'}";
+  } else if (args["options/device"]=="OpenMP") {
+    mode = "{mode: 'OpenMP'}";
+  } else if (args["options/device"]=="OpenCL") {
+    mode = "{mode: 'OpenCL', platform_id: 0, device_id: 0}";
+  } else if (args["options/device"]=="CUDA") {
+    mode = "{mode: 'CUDA', device_id: 0}";
+  } else if (args["options/device"]=="HIP") {
+    mode = "{mode: 'HIP', device_id: 0}";
+  } else if (args["options/device"]=="SYCL") {
+    mode = "{mode: 'SYCL', device_id: 0}";
+  }
+  // Create & setup occa::device
+  occa::device device(mode);
+
+  const int maxBlocks = 512;
+  const int blockSize = 256;
+
+  const int entries = std::stoi(args["options/entries"]);
+  const int iterations = std::stoi(args["options/iterations"]);
+  const int Nblocks = (entries < maxBlocks) ? entries : maxBlocks;
+
+  const float alpha = 0.5f;
+  const float beta  = 2.0f;
+
+  std::vector<float> x(entries), y(entries), w(entries);
+
+  std::mt19937 gen(0);
+  std::uniform_real_distribution<float> dist(-1, 1);
+
+  for (int i = 0; i < entries; ++i) {
+    x[i] = dist(gen);
+    y[i] = dist(gen);
+    w[i] = dist(gen);
+  }
+
+  occa::memory o_x = device.malloc<float>(entries, x.data());
+  occa::memory o_y = device.malloc<float>(entries, y.data());
+  occa::memory o_w = device.malloc<float>(entries, w.data());
+  occa::memory o_z = device.malloc<float>(entries);
+
+  // Temporary for the unfused path
+  occa::memory o_contrib = device.malloc<double>(entries);
+
+  occa::memory o_scratch = device.malloc<double>(maxBlocks);
+  occa::memory o_result = device.malloc<double>(1);
+
+  occa::json properties;
+  properties["defines"].asObject();
+  properties["defines/MAX_BLOCKS"] = maxBlocks;
+  properties["defines/BLOCK_SIZE"] = blockSize;
+
+  occa::kernel sumKernel = device.buildKernel(
+                                    OCCA_BUILD_DIR "/03_Reduction/sum.okl",
+                                    "sum",
+                                    properties);
+
+  const std::vector<fusedCase> cases = {
+    /*name                   operation     write  inputs*/
+    {"dot",                  DOT,          false, 2},
+    {"norm2",                NORM2,        false, 1},
+    {"axpy+norm2",           AXPY_NORM2,   false, 2},
+    {"axpy+norm2 (write)",   AXPY_NORM2,   true,  2},
+    {"weightedSum",          WEIGHTED_SUM, false, 3},
+    {"weightedSum (write)",  WEIGHTED_SUM, true,  3},
+  };
+
+  std::cout << std::left << std::setw(22) << "operation"
+            << std::right << std::setw(10) << "MB unfus"
+            << std::setw(10) << "MB fused"
+            << std::setw(10) << "saved"
+            << std::setw(12) << "unfus [ms]"
+            << std::setw(12) << "fused [ms]"
+            << std::setw(9) << "speedup" << std::endl;
+
+  bool passed = true;
+
+  /*
+  Results are poisoned before each timed path, so a kernel that writes
+  nothing cannot pass on the previous path's values
+  */
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  const std::vector<float> nanVector(entries, std::numeric_limits<float>::quiet_NaN());
+
+  for (const fusedCase &c : cases) {
+    occa::json caseProperties = properties;
+    caseProperties["defines/OPERATION"] = static_cast<int>(c.op);
+    caseProperties["defines/WRITE_MAPPED"] = c.writeMapped ? 1 : 0;
+
+    occa::kernel mapReduce = device.buildKernel(
+                                    OCCA_BUILD_DIR "/15_Fused_Reductions/mapReduce.okl",
+                                    "mapReduce",
+                                    caseProperties);
+    occa::kernel mapOnly   = device.buildKernel(
+                                    OCCA_BUILD_DIR "/15_Fused_Reductions/mapReduce.okl",
+                                    "mapOnly",
+                                    caseProperties);
+
+    /*Compute reference*/
+    std::vector<float> zRef(entries);
+    double ref = 0.0, tolerance = 0.0;
+    for (int i = 0; i < entries; ++i) {
+      float z = 0.0f;
+      double contrib = 0.0;
+      switch (c.op) {
+        case DOT:
+          z = x[i] * y[i];
+          contrib = z;
+          break;
+        case NORM2:
+          z = x[i];
+          contrib = (double) z * (double) z;
+          break;
+        case AXPY_NORM2:
+          z = alpha * x[i] + y[i];
+          contrib = (double) z * (double) z;
+          break;
+        case WEIGHTED_SUM:
+          z = alpha * x[i] + beta * y[i];
+          contrib = (double) w[i] * (double) z;
+          break;
+      }
+      zRef[i] = z;
+      ref += contrib;
+      tolerance += std::abs(contrib);
+    }
+    // The backend may contract the float map into FMAs, so allow for float rounding
+    tolerance *= 1.0E-6;
+
+    // The reductions are sums of squares, report the norms themselves
+    const bool norm = (c.op == NORM2 || c.op == AXPY_NORM2);
+
+    auto check = [&]() {
+      double result;
+      o_result.copyTo(&result);
+      const bool resultOk = norm
+        ? (std::abs(std::sqrt(result) - std::sqrt(ref)) <= tolerance / (2 * std::sqrt(ref)))
+        : (std::abs(result - ref) <= tolerance);
+      passed = passed && resultOk;
+
+      if (c.writeMapped) {
+        std::vector<float> z(entries);
+        o_z.copyTo(z.data());
+        for (int i = 0; i < entries; ++i) {
+          if (!(std::abs(z[i] - zRef[i]) <= 1.0E-6 * (std::abs(zRef[i]) + 1.0f))) {
+            passed = false;
+            break;
+          }
+        }
+      }
+    };
+
+    auto poison = [&]() {
+      o_result.copyFrom(&nan);
+      o_z.copyFrom(nanVector.data());
+    };
+
+    poison();
+    const double unfusedTime = timeKernel(device, iterations, [&]() {
+      mapOnly(entries, alpha, beta, o_x, o_y, o_w, o_z, o_contrib);
+      sumKernel(entries, Nblocks, o_contrib, o_scratch, o_result);
+    });
+    check();
+
+    poison();
+    const double fusedTime = timeKernel(device, iterations, [&]() {
+      mapReduce(entries, Nblocks, alpha, beta, o_x, o_y, o_w, o_z, o_scratch, o_result);
+    });
+    check();
+
+    /*
+    Both paths read the inputs and optionally write z. The unfused path
+    also writes and re-reads a double temporary.
+    */
+    const double fusedBytes = sizeof(float) * (c.inputs + (c.writeMapped ? 1.0 : 0.0)) * entries;
+    const double unfusedBytes = fusedBytes + 2.0 * sizeof(double) * entries;
+
+    printCase(c.name, unfusedBytes, fusedBytes, unfusedTime, fusedTime);
+  }
+
+  /*
+  The motivating case, ||a + b||: addVectors writes ab, ab is squared into
+  a double copy, and the sum kernel reduces it. Three passes and two
+  temporaries, against one fused pass that only reads a and b.
+  */
+  {
+    occa::json caseProperties = properties;
+    caseProperties["defines/OPERATION"] = static_cast<int>(AXPY_NORM2);
+    caseProperties["defines/WRITE_MAPPED"] = 0;
+
+    occa::kernel addVectors     = device.buildKernel(
+                                    OCCA_BUILD_DIR "/01_Introduction/addVectors.okl",
+                                    "addVectors");
+    occa::kernel squareToDouble = device.buildKernel(
+                                    OCCA_BUILD_DIR "/15_Fused_Reductions/mapReduce.okl",
+                                    "squareToDouble",
+                                    caseProperties);
+    occa::kernel mapReduce      = device.buildKernel(
+                                    OCCA_BUILD_DIR "/15_Fused_Reductions/mapReduce.okl",
+                                    "mapReduce",
+                                    caseProperties);
+
+    double ref = 0.0;
+    for (int i = 0; i < entries; ++i) {
+      const float ab = x[i] + y[i];
+      ref += (double) ab * (double) ab;
+    }
+
+    // Compared as the norm ||a+b||, not its square
+    ref = std::sqrt(ref);
+
+    double result;
+    o_result.copyFrom(&nan);
+    const double unfusedTime = timeKernel(device, iterations, [&]() {
+      addVectors(entries, o_x, o_y, o_z);
+      squareToDouble(entries, o_z, o_contrib);
+      sumKernel(entries, Nblocks, o_contrib, o_scratch, o_result);
+    });
+
+    o_result.copyTo(&result);
+    passed = passed && (std::abs(std::sqrt(result) - ref) <= 1.0E-6 * ref);
+
+    o_result.copyFrom(&nan);
+    const double fusedTime = timeKernel(device, iterations, [&]() {
+      mapReduce(entries, Nblocks, 1.0f, 0.0f, o_x, o_y, o_w, o_z, o_scratch, o_result);
+    });
+
+    o_result.copyTo(&result);
+    passed = passed && (std::abs(std::sqrt(result) - ref) <= 1.0E-6 * ref);
+
+    // addVectors: 2 reads + 1 write, square: 1 float read + 1 double write, sum: 1 double read
+    const double unfusedBytes = (3.0 * sizeof(float) + sizeof(float) + 2.0 * sizeof(double)) * entries;
+    const double fusedBytes = 2.0 * sizeof(float) * entries;
+
+    std::cout << std::endl;
+    printCase("||a+b|| (3 kernels)", unfusedBytes, fusedBytes, unfusedTime, fusedTime);
+  }
+
+  if (!passed) {
+    std::cout << "FAILED" << std::endl;
+    throw 1;
+  }
+  std::cout << "PASSED!" << std::endl;
+  return 0;
+}
@@ -0,0 +1,276 @@
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <algorithm>
+#include <fstream>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <occa.hpp>
+
+//---[ Internal Tools ]-----------------
+// Note: These headers are not officially supported
+//       Please don't rely on it outside of the occa examples
+#include <occa/internal/utils/cli.hpp>
+#include <occa/internal/utils/testing.hpp>
+//======================================
+
+occa::json parseArgs(int argc, const char **argv) {
+  occa::cli::parser parser;
+  parser
+    .withDescription(
+      "Performance regression check against stored baselines"
+    )
+    .addOption(
+      occa::cli::option('d', "device",
+                        "Device mode. Can be Serial, OpenMP, OpenCL, CUDA, HIP, or SYCL (default: Serial)")
+      .withArg()
+      .withDefaultValue("Serial")
+    )
+    .addOption(
+      occa::cli::option('b', "baselines",
+                        "Directory holding one <hostname>.json baseline per machine")
+      .withArg()
+      .withDefaultValue("baselines")
+    )
+    .addOption(
+      occa::cli::option('t', "threshold",
+                        "Percent drop in median throughput that counts as a regression")
+      .withArg()
+      .withDefaultValue("10")
+    )
+    .addOption(
+      occa::cli::option('r', "repetitions",
+                        "Timed repetitions per kernel. The median is compared")
+      .withArg()
+      .withDefaultValue("11")
+    )
+    .addOption(
+      occa::cli::option("record",
+                        "Record the measured medians as this machine's new baseline")
+    );
+
+  occa::json args = parser.parseArgs(argc, argv);
+  return args;
+}
+
+// ctest treats this return code as a skipped test
+const int skipReturnCode = 77;
+
+struct measurement {
+  std::string kernel;
+  std::string unit;
+  double median;
+};
+
+/*
+Median throughput of a kernel over a number of repetitions. Each
+repetition is timed between stream tags, and the work per repetition is
+given in the throughput's unit (bytes or flops).
+*/
+template <class Launch>
+double medianThroughput(occa::device &device,
+                        const int repetitions,
+                        const double work,
+                        Launch launch) {
+  // Warm up
+  launch();
+  device.finish();
+
+  std::vector<double> rates(repetitions);
+  for (int r = 0; r < repetitions; ++r) {
+    occa::streamTag start = device.tagStream();
+    launch();
+    occa::streamTag end = device.tagStream();
+    device.waitFor(end);
+    rates[r] = work / device.timeBetween(start, end) / 1.0E9;
+  }
+  std::sort(rates.begin(), rates.end());
+  return rates[repetitions / 2];
+}
+
+std::string hostname() {
+  char name[256];
+  if (gethostname(name, sizeof(name)) != 0) {
+    return "unknown";
+  }
+  name[sizeof(name) - 1] = '\0';
+  return name;
+}
+
+int main(int argc, const char **argv) {
+
+  // Parse arguments to json
+  occa::json args = parseArgs(argc, argv);
+
+  std::string mode;
+  if (args["options/device"]=="Serial") {
+    mode = "{mode: 'Serial'}";
+  } else if (args["options/device"]=="OpenMP") {
+    mode = "{mode: 'OpenMP'}";
+  } else if (args["options/device"]=="OpenCL") {
+    mode = "{mode: 'OpenCL', platform_id: 0, device_id: 0}";
+  } else if (args["options/device"]=="CUDA") {
+    mode = "{mode: 'CUDA', device_id: 0}";
+  } else if (args["options/device"]=="HIP") {
+    mode = "{mode: 'HIP', device_id: 0}";
+  } else if (args["options/device"]=="SYCL") {
+    mode = "{mode: 'SYCL', device_id: 0}";
+  }
+  // Create & setup occa::device
+  occa::device device(mode);
+
+  /*
+  OCCA falls back to Serial when a backend is unavailable. Comparing
+  those numbers against the requested backend's baseline would be
+  meaningless, so skip instead.
+  */
+  const std::string requestedMode = args["options/device"];
+  if (device.mode() != requestedMode) {
+    std::cout << requestedMode << " is not available, skipping" << std::endl;
+    return skipReturnCode;
+  }
+
+  const int repetitions = std::stoi(args["options/repetitions"]);
+  const double threshold = std::stod(args["options/threshold"]);
+  const bool record = args["options/record"];
+
+  const std::string baselineDir = args["options/baselines"];
+  const std::string baselineFile = baselineDir + "/" + hostname() + ".json";
+
+  // Fixed problem sizes, so runs are comparable over time
+  const int entries = 1 << 22;
+  const int dim = 256;
+  const int maxBlocks = 512;
+
+  std::mt19937 gen(0);
+  std::uniform_real_distribution<float> dist(-1, 1);
+
+  std::vector<float> a(entries), b(entries);
+  std::vector<double> x(entries);
+  for (int i = 0; i < entries; ++i) {
+    a[i] = dist(gen);
+    b[i] = dist(gen);
+    x[i] = dist(gen);
+  }
+  std::vector<float> A(dim * dim), B(dim * dim);
+  for (float &v : A) v = dist(gen);
+  for (float &v : B) v = dist(gen);
+
+  occa::memory o_a  = device.malloc<float>(entries, a.data());
+  occa::memory o_b  = device.malloc<float>(entries, b.data());
+  occa::memory o_ab = device.malloc<float>(entries);
+  occa::memory o_x  = device.malloc<double>(entries, x.data());
+  occa::memory o_A  = device.malloc<float>(dim * dim, A.data());
+  occa::memory o_B  = device.malloc<float>(dim * dim, B.data());
+  occa::memory o_C  = device.malloc<float>(dim * dim);
+  occa::memory o_scratch = device.malloc<double>(maxBlocks);
+  occa::memory o_sum = device.malloc<double>(1);
+
+  occa::json gemmProperties;
+  gemmProperties["defines"].asObject();
+  gemmProperties["defines/N_TILE_SIZE"] = 16;
+  gemmProperties["defines/M_TILE_SIZE"] = 16;
+
+  occa::json sumProperties;
+  sumProperties["defines"].asObject();
+  sumProperties["defines/MAX_BLOCKS"] = maxBlocks;
+  sumProperties["defines/BLOCK_SIZE"] = 256;
+
+  occa::kernel addVectors     = device.buildKernel(
+                                    OCCA_BUILD_DIR "/01_Introduction/addVectors.okl",
+                                    "addVectors");
+  occa::kernel matrixMultiply = device.buildKernel(
+                                    OCCA_BUILD_DIR "/02_Loops/matrixMultiply.okl",
+                                    "matrixMultiply",
+                                    gemmProperties);
+  occa::kernel sumKernel      = device.buildKernel(
+                                    OCCA_BUILD_DIR "/03_Reduction/sum.okl",
+                                    "sum",
+                                    sumProperties);
+  occa::kernel multVectors    = device.buildKernel(
+                                    OCCA_BUILD_DIR "/04_Streams/kernels.okl",
+                                    "multVectors");
+
+  const int Nblocks = maxBlocks;
+
+  std::vector<measurement> results;
+  results.push_back({"addVectors", "GB/s",
+    medianThroughput(device, repetitions, 3.0 * sizeof(float) * entries, [&]() {
+      addVectors(entries, o_a, o_b, o_ab);
+    })});
+  results.push_back({"matrixMultiply", "GFLOP/s",
+    medianThroughput(device, repetitions, 2.0 * dim * dim * dim, [&]() {
+      matrixMultiply(dim, dim, dim, o_A, dim, o_B, dim, o_C, dim);
+    })});
+  results.push_back({"sum", "GB/s",
+    medianThroughput(device, repetitions, 1.0 * sizeof(double) * entries, [&]() {
+      sumKernel(entries, Nblocks, o_x, o_scratch, o_sum);
+    })});
+  results.push_back({"multVectors", "GB/s",
+    medianThroughput(device, repetitions, 3.0 * sizeof(float) * entries, [&]() {
+      multVectors(entries, o_a, o_b, o_ab);
+    })});
+
+  // Baselines for every backend of a machine share one file
+  occa::json baseline;
+  if (std::ifstream(baselineFile).good()) {
+    baseline = occa::json::read(baselineFile);
+  }
+
+  if (record) {
+    for (const measurement &m : results) {
+      baseline[requestedMode + "/" + m.kernel + "/median"] = m.median;
+      baseline[requestedMode + "/" + m.kernel + "/unit"] = m.unit;
+      std::cout << "Recorded " << requestedMode << " " << m.kernel << ": "
+                << m.median << " " << m.unit << std::endl;
+    }
+    // An existing directory is fine, write() reports anything else
+    mkdir(baselineDir.c_str(), 0755);
+    baseline.write(baselineFile);
+    std::cout << "Wrote " << baselineFile << std::endl;
+    return 0;
+  }
+
+  if (!baseline.has(requestedMode)) {
+    std::cout << "No " << requestedMode << " baseline in " << baselineFile
+              << ", skipping. Record one with --record" << std::endl;
+    return skipReturnCode;
+  }
+
+  std::cout << std::left << std::setw(16) << "kernel"
+            << std::right << std::setw(12) << "baseline"
+            << std::setw(12) << "median"
+            << std::setw(10) << "unit"
+            << std::setw(10) << "change" << std::endl;
+
+  bool regressed = false;
+  for (const measurement &m : results) {
+    const std::string path = requestedMode + "/" + m.kernel + "/median";
+    if (!baseline.has(path)) {
+      std::cout << std::left << std::setw(16) << m.kernel << "  no baseline" << std::endl;
+      continue;
+    }
+
+    const double reference = baseline[path].get<double>();
+    const double change = 100.0 * (m.median - reference) / reference;
+    const bool failed = (change < -threshold);
+    regressed = regressed || failed;
+
+    std::cout << std::left << std::setw(16) << m.kernel
+              << std::right << std::fixed << std::setprecision(2)
+              << std::setw(12) << reference
+              << std::setw(12) << m.median
+              << std::setw(10) << m.unit
+              << std::setw(9) << std::showpos << change << std::noshowpos << "%"
+              << (failed ? "  REGRESSION" : "") << std::endl;
+  }
+
+  if (regressed) {
+    std::cout << "FAILED: throughput dropped more than " << threshold << "% below baseline" << std::endl;
+    return 1;
+  }
+  std::cout << "PASSED!" << std::endl;
+  return 0;
+}
@@ -0,0 +1,372 @@
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <occa.hpp>
+
+//---[ Internal Tools ]-----------------
+// Note: These headers are not officially supported
+//       Please don't rely on it outside of the occa examples
+#include <occa/internal/utils/cli.hpp>
+#include <occa/internal/utils/testing.hpp>
+//======================================
+
+#include "scalingTable.hpp"
+
+occa::json parseArgs(int argc, const char **argv) {
+  occa::cli::parser parser;
+  parser
+    .withDescription(
+      "Thread scaling and problem size sweep of the tutorial kernels"
+    )
+    .addOption(
+      occa::cli::option('d', "device",
+                        "Device mode. Thread counts are only swept in OpenMP mode (default: OpenMP)")
+      .withArg()
+      .withDefaultValue("OpenMP")
+    )
+    .addOption(
+      occa::cli::option('t', "threads",
+                        "Comma separated thread counts (default: powers of two up to the core count)")
+      .withArg()
+      .withDefaultValue("")
+    )
+    .addOption(
+      occa::cli::option('k', "kernels",
+                        "Comma separated kernels to sweep")
+      .withArg()
+      .withDefaultValue("addVectors,multVectors,sum,matrixMultiply")
+    )
+    .addOption(
+      occa::cli::option("min-bytes",
+                        "Smallest vector working set (default: half of L1)")
+      .withArg()
+      .withDefaultValue("0")
+    )
+    .addOption(
+      occa::cli::option("max-bytes",
+                        "Largest vector working set (default: 8x the last level cache, at least 256 MiB)")
+      .withArg()
+      .withDefaultValue("0")
+    )
+    .addOption(
+      occa::cli::option("max-dim",
+                        "Largest matrixMultiply dimension")
+      .withArg()
+      .withDefaultValue("1024")
+    )
+    .addOption(
+      occa::cli::option("min-time",
+                        "Minimum milliseconds per timed batch")
+      .withArg()
+      .withDefaultValue("20")
+    )
+    .addOption(
+      occa::cli::option("knee-drop",
+                        "Percent drop in throughput that marks a knee point")
+      .withArg()
+      .withDefaultValue("15")
+    );
+
+  occa::json args = parser.parseArgs(argc, argv);
+  return args;
+}
+
+std::vector<std::string> split(const std::string &list) {
+  std::vector<std::string> entries;
+  std::stringstream ss(list);
+  std::string entry;
+  while (std::getline(ss, entry, ',')) {
+    entries.push_back(entry);
+  }
+  return entries;
+}
+
+bool contains(const std::vector<std::string> &list, const std::string &entry) {
+  return std::find(list.begin(), list.end(), entry) != list.end();
+}
+
+/*
+The OpenMP runtime is shared by this process and the kernel libraries
+OCCA loads into it, so setting the thread count here applies to the
+following launches. OMP_NUM_THREADS is also set for runtimes that read
+it when the device is created.
+*/
+void setThreadCount(const int threads) {
+  setenv("OMP_NUM_THREADS", std::to_string(threads).c_str(), 1);
+#ifdef _OPENMP
+  omp_set_num_threads(threads);
+#endif
+}
+
+int main(int argc, const char **argv) {
+
+  // Parse arguments to json
+  occa::json args = parseArgs(argc, argv);
+
+  std::string mode;
+  if (args["options/device"]=="Serial") {
+    mode = "{mode: 'Serial'}";
+  } else if (args["options/device"]=="OpenMP") {
+    mode = "{mode: 'OpenMP'}";
+  } else if (args["options/device"]=="OpenCL") {
+    mode = "{mode: 'OpenCL', platform_id: 0, device_id: 0}";
+  } else if (args["options/device"]=="CUDA") {
+    mode = "{mode: 'CUDA', device_id: 0}";
+  } else if (args["options/device"]=="HIP") {
+    mode = "{mode: 'HIP', device_id: 0}";
+  } else if (args["options/device"]=="SYCL") {
+    mode = "{mode: 'SYCL', device_id: 0}";
+  }
+  const std::string requestedMode = args["options/device"];
+
+  const std::vector<std::string> kernels = split(args["options/kernels"]);
+  const int maxDim = std::stoi(args["options/max-dim"]);
+  const double minTime = std::stod(args["options/min-time"]) / 1.0E3;
+  const double kneeDrop = std::stod(args["options/knee-drop"]) / 100.0;
+
+  std::vector<int> threadCounts;
+  for (const std::string &t : split(args["options/threads"])) {
+    threadCounts.push_back(std::stoi(t));
+  }
+  if (requestedMode != "OpenMP") {
+    threadCounts = {1};
+  } else if (threadCounts.empty()) {
+    const int cores = std::max(1u, std::thread::hardware_concurrency());
+    for (int p = 1; p < cores; p *= 2) {
+      threadCounts.push_back(p);
+    }
+    threadCounts.push_back(cores);
+  }
+  // Efficiencies are relative to one thread
+  std::sort(threadCounts.begin(), threadCounts.end());
+  threadCounts.erase(std::unique(threadCounts.begin(), threadCounts.end()), threadCounts.end());
+  if (threadCounts.front() != 1) {
+    threadCounts.insert(threadCounts.begin(), 1);
+  }
+
+#ifndef _OPENMP
+  if (threadCounts.size() > 1) {
+    std::cout << "Warning: built without OpenMP, thread counts after the first "
+              << "only apply if the runtime rereads OMP_NUM_THREADS" << std::endl;
+  }
+#endif
+
+  const std::vector<cacheLevel> caches = queryCacheLevels();
+  std::cout << "Caches:";
+  for (const cacheLevel &level : caches) {
+    std::cout << "  " << level.name << " " << formatBytes(level.bytes)
+              << (level.perCore ? " per core" : " shared");
+  }
+  std::cout << std::endl << std::endl;
+
+  /*
+  Vector sizes double from L1-resident to well past the last level cache,
+  so the far end is DRAM-bound. The sizes are given as the working set of
+  addVectors, three floats per entry.
+  */
+  const double l1Bytes   = caches.empty() ? 32 * 1024.0 : caches.front().bytes;
+  const double lastBytes = caches.empty() ? 32 * 1024.0 * 1024 : caches.back().bytes;
+
+  double minBytes = std::stod(args["options/min-bytes"]);
+  double maxBytes = std::stod(args["options/max-bytes"]);
+  if (minBytes <= 0) minBytes = l1Bytes / 2;
+  if (maxBytes <= 0) maxBytes = std::max(8 * lastBytes, 256 * 1024.0 * 1024);
+
+  std::vector<int> vectorSizes;
+  for (long n = 256; 3 * sizeof(float) * n <= maxBytes; n *= 2) {
+    if (3 * sizeof(float) * n >= minBytes) {
+      vectorSizes.push_back(n);
+    }
+  }
+
+  // matrixMultiply dimensions grow by 2^(1/3), so the work doubles between them
+  std::vector<int> matrixSizes;
+  for (int i = 0; ; ++i) {
+    const int dim = (int) std::round(16 * std::pow(2.0, i / 3.0));
+    if (dim > maxDim) break;
+    matrixSizes.push_back(dim);
+  }
+
+  const int maxEntries = vectorSizes.empty() ? 0 : vectorSizes.back();
+  const int maxMatrixDim = matrixSizes.empty() ? 0 : matrixSizes.back();
+
+  std::mt19937 gen(0);
+  std::uniform_real_distribution<float> dist(-1, 1);
+
+  std::vector<float> a(maxEntries), b(maxEntries), ab(maxEntries);
+  std::vector<double> x(maxEntries);
+  for (int i = 0; i < maxEntries; ++i) {
+    a[i] = dist(gen);
+    b[i] = dist(gen);
+    x[i] = dist(gen);
+  }
+  std::vector<float> A(maxMatrixDim * maxMatrixDim), B(maxMatrixDim * maxMatrixDim);
+  for (float &v : A) v = dist(gen);
+  for (float &v : B) v = dist(gen);
+
+  const int maxBlocks = 512;
+
+  occa::json gemmProperties;
+  gemmProperties["defines"].asObject();
+  gemmProperties["defines/N_TILE_SIZE"] = 16;
+  gemmProperties["defines/M_TILE_SIZE"] = 16;
+
+  occa::json sumProperties;
+  sumProperties["defines"].asObject();
+  sumProperties["defines/MAX_BLOCKS"] = maxBlocks;
+  sumProperties["defines/BLOCK_SIZE"] = 256;
+
+  scalingTable addTable("addVectors", "GB/s", threadCounts);
+  scalingTable multTable("multVectors", "GB/s", threadCounts);
+  scalingTable sumTable("sum", "GB/s", threadCounts);
+  scalingTable gemmTable("matrixMultiply", "GFLOP/s", threadCounts);
+
+  bool passed = true;
+
+  for (const int threads : threadCounts) {
+    setThreadCount(threads);
+
+    // A fresh device per thread count, so no state carries over between runs
+    occa::device device(mode);
+    if (device.mode() != requestedMode) {
+      std::cout << requestedMode << " is not available" << std::endl;
+      throw 1;
+    }
+
+    std::cout << "Sweeping " << threads << " thread" << (threads > 1 ? "s" : "") << std::endl;
+
+    occa::kernel addVectors     = device.buildKernel(
+                                    OCCA_BUILD_DIR "/01_Introduction/addVectors.okl",
+                                    "addVectors");
+    occa::kernel multVectors    = device.buildKernel(
+                                    OCCA_BUILD_DIR "/04_Streams/kernels.okl",
+                                    "multVectors");
+    occa::kernel sumKernel      = device.buildKernel(
+                                    OCCA_BUILD_DIR "/03_Reduction/sum.okl",
+                                    "sum",
+                                    sumProperties);
+    occa::kernel matrixMultiply = device.buildKernel(
+                                    OCCA_BUILD_DIR "/02_Loops/matrixMultiply.okl",
+                                    "matrixMultiply",
+                                    gemmProperties);
+
+    // Allocated once at the largest size, smaller problems use a prefix
+    occa::memory o_a  = device.malloc<float>(maxEntries, a.data());
+    occa::memory o_b  = device.malloc<float>(maxEntries, b.data());
+    occa::memory o_ab = device.malloc<float>(maxEntries);
+    occa::memory o_x  = device.malloc<double>(maxEntries, x.data());
+    occa::memory o_scratch = device.malloc<double>(maxBlocks);
+    occa::memory o_sum = device.malloc<double>(1);
+
+    for (const int n : vectorSizes) {
+      const double vectorBytes = 3.0 * sizeof(float) * n;
+
+      if (contains(kernels, "addVectors")) {
+        addTable.add(threads, n, vectorBytes, vectorBytes,
+                     timeLaunch(device, minTime, [&]() {
+                       addVectors(n, o_a, o_b, o_ab);
+                     }));
+      }
+      if (contains(kernels, "multVectors")) {
+        multTable.add(threads, n, vectorBytes, vectorBytes,
+                      timeLaunch(device, minTime, [&]() {
+                        multVectors(n, o_a, o_b, o_ab);
+                      }));
+      }
+      if (contains(kernels, "sum")) {
+        const int Nblocks = (n < maxBlocks) ? n : maxBlocks;
+        const double sumBytes = sizeof(double) * n;
+        sumTable.add(threads, n, sumBytes, sumBytes,
+                     timeLaunch(device, minTime, [&]() {
+                       sumKernel(n, Nblocks, o_x, o_scratch, o_sum);
+                     }));
+      }
+    }
+
+    /*Verify the largest vector runs*/
+    if (maxEntries > 0) {
+      // multVectors runs after addVectors and overwrites ab
+      const bool mult = contains(kernels, "multVectors");
+      if (mult || contains(kernels, "addVectors")) {
+        o_ab.copyTo(ab.data());
+        for (int i = 0; i < maxEntries; ++i) {
+          if (ab[i] != (mult ? a[i] * b[i] : a[i] + b[i])) {
+            passed = false;
+            break;
+          }
+        }
+      }
+      if (contains(kernels, "sum")) {
+        double sum, ref = 0.0, tolerance = 0.0;
+        o_sum.copyTo(&sum);
+        for (int i = 0; i < maxEntries; ++i) {
+          ref += x[i];
+          tolerance += std::abs(x[i]);
+        }
+        passed = passed && (std::abs(sum - ref) <= 1.0E-12 * tolerance);
+      }
+    }
+
+    if (contains(kernels, "matrixMultiply") && maxMatrixDim > 0) {
+      occa::memory o_A = device.malloc<float>(maxMatrixDim * maxMatrixDim, A.data());
+      occa::memory o_B = device.malloc<float>(maxMatrixDim * maxMatrixDim, B.data());
+      occa::memory o_C = device.malloc<float>(maxMatrixDim * maxMatrixDim);
+
+      for (const int dim : matrixSizes) {
+        gemmTable.add(threads, dim,
+                      3.0 * sizeof(float) * dim * dim,
+                      2.0 * dim * dim * dim,
+                      timeLaunch(device, minTime, [&]() {
+                        matrixMultiply(dim, dim, dim, o_A, dim, o_B, dim, o_C, dim);
+                      }));
+      }
+
+      /*Verify the first column of the largest product*/
+      const int dim = maxMatrixDim;
+      std::vector<float> C(dim);
+      o_C.copyTo(C.data(), dim * sizeof(float));
+      for (int m = 0; m < dim; ++m) {
+        float c = 0.0f;
+        for (int k = 0; k < dim; ++k) {
+          c += A[m + k * dim] * B[k];
+        }
+        if (std::abs(C[m] - c) > 1.0E-5 * dim) {
+          passed = false;
+        }
+      }
+    }
+  }
+  std::cout << std::endl;
+
+  std::vector<const scalingTable*> tables;
+  if (contains(kernels, "addVectors"))     tables.push_back(&addTable);
+  if (contains(kernels, "multVectors"))    tables.push_back(&multTable);
+  if (contains(kernels, "sum"))            tables.push_back(&sumTable);
+  if (contains(kernels, "matrixMultiply")) tables.push_back(&gemmTable);
+
+  for (const scalingTable *table : tables) {
+    table->printThroughput(std::cout);
+    if (threadCounts.size() > 1) {
+      table->printStrongScaling(std::cout);
+      table->printWeakScaling(std::cout);
+    }
+    table->printKnees(std::cout, caches, kneeDrop);
+  }
+
+  if (!passed) {
+    std::cout << "FAILED" << std::endl;
+    throw 1;
+  }
+  std::cout << "PASSED!" << std::endl;
+  return 0;
+}
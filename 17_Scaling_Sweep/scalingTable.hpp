@@ -0,0 +1,329 @@
+#ifndef SCALING_TABLE_HPP
+#define SCALING_TABLE_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include <occa.hpp>
+
+struct cacheLevel {
+  std::string name;
+  double bytes;
+  // L1 and L2 are per core, so their capacity grows with the thread count
+  bool perCore;
+};
+
+// Parses sizes such as "48K" or "32M" from sysfs
+inline double parseCacheSize(const std::string &size) {
+  double bytes = std::atof(size.c_str());
+  if (size.find('K') != std::string::npos) bytes *= 1024;
+  if (size.find('M') != std::string::npos) bytes *= 1024 * 1024;
+  return bytes;
+}
+
+/*
+Data cache sizes of the host. sysconf reports them on glibc systems, but
+returns 0 in some containers and on some architectures, in which case
+the sysfs description of cpu0 is read instead.
+*/
+inline std::vector<cacheLevel> queryCacheLevels() {
+  std::vector<cacheLevel> levels;
+
+#ifdef _SC_LEVEL1_DCACHE_SIZE
+  const long sizes[3] = {
+    sysconf(_SC_LEVEL1_DCACHE_SIZE),
+    sysconf(_SC_LEVEL2_CACHE_SIZE),
+    sysconf(_SC_LEVEL3_CACHE_SIZE)
+  };
+  for (int l = 0; l < 3; ++l) {
+    if (sizes[l] > 0) {
+      levels.push_back({"L" + std::to_string(l + 1), (double) sizes[l], l < 2});
+    }
+  }
+#endif
+  if (!levels.empty()) {
+    return levels;
+  }
+
+  for (int index = 0; ; ++index) {
+    const std::string dir = "/sys/devices/system/cpu/cpu0/cache/index" + std::to_string(index);
+    std::ifstream levelFile(dir + "/level"), typeFile(dir + "/type"), sizeFile(dir + "/size");
+    if (!levelFile || !typeFile || !sizeFile) {
+      break;
+    }
+    int level;
+    std::string type, size;
+    levelFile >> level;
+    typeFile >> type;
+    sizeFile >> size;
+    if (type == "Instruction") {
+      continue;
+    }
+    levels.push_back({"L" + std::to_string(level), parseCacheSize(size), level < 3});
+  }
+  return levels;
+}
+
+inline std::string formatBytes(const double bytes) {
+  std::stringstream ss;
+  ss << std::fixed << std::setprecision(1);
+  if (bytes >= 1024.0 * 1024 * 1024) {
+    ss << bytes / (1024.0 * 1024 * 1024) << " GiB";
+  } else if (bytes >= 1024.0 * 1024) {
+    ss << bytes / (1024.0 * 1024) << " MiB";
+  } else {
+    ss << bytes / 1024.0 << " KiB";
+  }
+  return ss.str();
+}
+
+/*
+Seconds per launch. Small problems finish in microseconds, so launches
+are batched until a batch runs for at least minTime, and the fastest of
+a few batches is kept.
+*/
+template <class Launch>
+double timeLaunch(occa::device &device, const double minTime, Launch launch) {
+  // Warm up, and a first estimate of the launch time
+  occa::streamTag start = device.tagStream();
+  launch();
+  occa::streamTag end = device.tagStream();
+  device.waitFor(end);
+  const double estimate = std::max(device.timeBetween(start, end), 1.0E-7);
+
+  const int iterations = std::min(100000, std::max(1, (int) (minTime / estimate)));
+
+  double best = estimate;
+  for (int batch = 0; batch < 3; ++batch) {
+    start = device.tagStream();
+    for (int it = 0; it < iterations; ++it) {
+      launch();
+    }
+    end = device.tagStream();
+    device.waitFor(end);
+    best = std::min(best, device.timeBetween(start, end) / iterations);
+  }
+  return best;
+}
+
+/*
+Throughput of one kernel over a grid of problem sizes and thread counts.
+Each sample records the bytes the kernel touches (its working set) and
+the work it does, in the unit the throughput is reported in. From the
+grid:
+
+  strong scaling efficiency   rate(p, n) / (p * rate(1, n))
+  weak scaling efficiency     rate(p, m) / (p * rate(1, n)),  work(m) ~ p * work(n)
+  knee points                 sizes where the rate drops as the working
+                              set spills out of a cache level
+*/
+class scalingTable {
+ public:
+  scalingTable(const std::string &name_,
+               const std::string &unit_,
+               const std::vector<int> &threadCounts_) :
+    name(name_),
+    unit(unit_),
+    threadCounts(threadCounts_) {}
+
+  void add(const int threads,
+           const long size,
+           const double workingSet,
+           const double work,
+           const double seconds) {
+    sample &s = samples[size];
+    s.workingSet = workingSet;
+    s.work = work;
+    s.rates[threads] = work / seconds / 1.0E9;
+  }
+
+  void printThroughput(std::ostream &out) const {
+    printHeader(out, name + " [" + unit + "]");
+    for (const auto &it : samples) {
+      printRowLabel(out, it.first, it.second);
+      for (const int p : threadCounts) {
+        printValue(out, rate(it.second, p), 2);
+      }
+      out << std::endl;
+    }
+    out << std::endl;
+  }
+
+  void printStrongScaling(std::ostream &out) const {
+    printHeader(out, name + " strong scaling efficiency");
+    for (const auto &it : samples) {
+      printRowLabel(out, it.first, it.second);
+      const double serial = rate(it.second, 1);
+      for (const int p : threadCounts) {
+        const double parallel = rate(it.second, p);
+        printValue(out, (serial > 0 && parallel > 0) ? parallel / (p * serial) : -1, 2);
+      }
+      out << std::endl;
+    }
+    out << std::endl;
+  }
+
+  /*
+  Rows are the per-thread problem size. Sizes are spaced so the work
+  roughly doubles between them, and a thread count without a size within
+  10% of p times the row's work is left blank.
+  */
+  void printWeakScaling(std::ostream &out) const {
+    printHeader(out, name + " weak scaling efficiency");
+    for (const auto &it : samples) {
+      const double serial = rate(it.second, 1);
+      if (serial <= 0) {
+        continue;
+      }
+      printRowLabel(out, it.first, it.second);
+      for (const int p : threadCounts) {
+        const sample *scaled = findWork(p * it.second.work);
+        const double parallel = scaled ? rate(*scaled, p) : -1;
+        printValue(out, (parallel > 0) ? parallel / (p * serial) : -1, 2);
+      }
+      out << std::endl;
+    }
+    out << std::endl;
+  }
+
+  /*
+  A knee is a size where the rate falls more than `drop` below the best
+  rate since the previous knee, and stays there for the next size too so
+  a single noisy sample does not count. It is attributed to the cache
+  level whose capacity lies closest to the spill, with per-core levels
+  scaled by the thread count.
+  */
+  void printKnees(std::ostream &out,
+                  const std::vector<cacheLevel> &caches,
+                  const double drop) const {
+    out << name << " knee points (rate drop > " << (int) (100 * drop) << "%)" << std::endl;
+
+    for (const int p : threadCounts) {
+      std::vector<const sample*> curve;
+      for (const auto &it : samples) {
+        if (rate(it.second, p) > 0) {
+          curve.push_back(&it.second);
+        }
+      }
+
+      bool foundKnee = false;
+      double plateau = 0;
+      for (size_t i = 0; i < curve.size(); ++i) {
+        const double r = rate(*curve[i], p);
+        const double threshold = (1 - drop) * plateau;
+        const bool staysDown = (i + 1 == curve.size()) || (rate(*curve[i + 1], p) < threshold);
+
+        if (i > 0 && r < threshold && staysDown) {
+          const double before = curve[i - 1]->workingSet;
+          const double after = curve[i]->workingSet;
+
+          out << "  " << std::setw(3) << p << " threads: "
+              << std::setw(10) << formatBytes(before) << " -> "
+              << std::setw(10) << formatBytes(after)
+              << std::setw(7) << std::fixed << std::setprecision(0)
+              << 100 * (r / plateau - 1) << "%";
+
+          const cacheLevel *level = nearestLevel(caches, std::sqrt(before * after), p);
+          if (level) {
+            out << "  near " << level->name << " ("
+                << formatBytes(capacity(*level, p)) << (level->perCore && p > 1 ? " total" : "") << ")";
+          }
+          out << std::endl;
+
+          foundKnee = true;
+          plateau = r;
+        }
+        plateau = std::max(plateau, r);
+      }
+
+      if (!foundKnee) {
+        out << "  " << std::setw(3) << p << " threads: none" << std::endl;
+      }
+    }
+    out << std::endl;
+  }
+
+ private:
+  struct sample {
+    double workingSet;
+    double work;
+    std::map<int, double> rates;
+  };
+
+  std::string name;
+  std::string unit;
+  std::vector<int> threadCounts;
+
+  // Keyed on the problem size
+  std::map<long, sample> samples;
+
+  static double rate(const sample &s, const int threads) {
+    auto it = s.rates.find(threads);
+    return (it != s.rates.end()) ? it->second : -1;
+  }
+
+  const sample* findWork(const double work) const {
+    const sample *best = nullptr;
+    for (const auto &it : samples) {
+      const double error = std::abs(it.second.work / work - 1);
+      if (error < 0.1 && (!best || error < std::abs(best->work / work - 1))) {
+        best = &it.second;
+      }
+    }
+    return best;
+  }
+
+  static double capacity(const cacheLevel &level, const int threads) {
+    return level.perCore ? threads * level.bytes : level.bytes;
+  }
+
+  // Closest on a log scale, so a 1 MiB cache does not lose to a 32 KiB one at 600 KiB
+  static const cacheLevel* nearestLevel(const std::vector<cacheLevel> &caches,
+                                        const double workingSet,
+                                        const int threads) {
+    const cacheLevel *nearest = nullptr;
+    double nearestDistance = 0;
+    for (const cacheLevel &level : caches) {
+      const double distance = std::abs(std::log2(workingSet / capacity(level, threads)));
+      if (!nearest || distance < nearestDistance) {
+        nearest = &level;
+        nearestDistance = distance;
+      }
+    }
+    return nearest;
+  }
+
+  void printHeader(std::ostream &out, const std::string &title) const {
+    out << title << std::endl;
+    out << std::left << std::setw(10) << "size"
+        << std::right << std::setw(12) << "bytes";
+    for (const int p : threadCounts) {
+      out << std::setw(9) << ("p=" + std::to_string(p));
+    }
+    out << std::endl;
+  }
+
+  static void printRowLabel(std::ostream &out, const long size, const sample &s) {
+    out << std::left << std::setw(10) << size
+        << std::right << std::setw(12) << formatBytes(s.workingSet);
+  }
+
+  static void printValue(std::ostream &out, const double value, const int precision) {
+    if (value < 0) {
+      out << std::setw(9) << "-";
+    } else {
+      out << std::setw(9) << std::fixed << std::setprecision(precision) << value;
+    }
+  }
+};
+
+#endif